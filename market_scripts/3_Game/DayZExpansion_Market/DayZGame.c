@@ -12,17 +12,120 @@
 
 modded class DayZGame
 {
+	static const int EXPANSION_MARKET_AMMOBOX_CACHE_VERSION = 1;
+
+	//! Number of CfgVehicles entries scanned per frame while rebuilding the ammo box map in the background
+	static const int EXPANSION_MARKET_AMMOBOX_SCAN_BATCH = 1000;
+
 	protected static ref map<string, string> m_Expansion_MarketAmmoBoxes = new map<string, string>;
 
+	protected int m_Expansion_MarketAddonsHash;
+	protected int m_Expansion_MarketAmmoBoxesScanIndex = -1;
+	protected int m_Expansion_MarketAmmoBoxesScanTicks;
+
 	void DayZGame()
 	{
 		//! Ammo boxes and corresponding ammo are only needed on client
 	#ifndef SERVER
-		int count = ConfigGetChildrenCount(CFG_VEHICLESPATH);
-	
-		EXPrint(ToString() + " - enumerating " + count + " " + CFG_VEHICLESPATH + " entries");
+		int start = TickCount(0);
+
+		m_Expansion_MarketAddonsHash = Expansion_GetAddonsHash();
+
+		if (Expansion_LoadMarketAmmoBoxes())
+		{
+			EXPrint(ToString() + " - loaded " + m_Expansion_MarketAmmoBoxes.Count() + " ammo boxes with corresponding ammo from cache (hit) in " + (TickCount(start) / 10000.0) + " ms");
+		}
+		else
+		{
+			EXPrint(ToString() + " - ammo box cache miss, rebuilding from " + CFG_VEHICLESPATH + " in background");
+
+			m_Expansion_MarketAmmoBoxes.Clear();
+			m_Expansion_MarketAmmoBoxesScanIndex = 0;
+			m_Expansion_MarketAmmoBoxesScanTicks = TickCount(start);
+
+			GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(Expansion_ScanMarketAmmoBoxes, 0, false, EXPANSION_MARKET_AMMOBOX_SCAN_BATCH);
+		}
+	#endif
+	}
+
+	//! Combined hash of all loaded CfgPatches entries, changes whenever the mod set changes
+	protected int Expansion_GetAddonsHash()
+	{
+		int count = ConfigGetChildrenCount("CfgPatches");
+		int hash = count;
 
 		for (int i = 0; i < count; i++)
+		{
+			string addonName;
+			ConfigGetChildName("CfgPatches", i, addonName);
+			hash = hash * 31 + addonName.Hash();
+		}
+
+		return hash;
+	}
+
+	protected bool Expansion_LoadMarketAmmoBoxes()
+	{
+		if (!FileExist(EXPANSION_MARKET_AMMOBOX_CACHE))
+			return false;
+
+		FileSerializer file = new FileSerializer();
+		if (!file.Open(EXPANSION_MARKET_AMMOBOX_CACHE, FileMode.READ))
+			return false;
+
+		int version;
+		int hash;
+		TStringArray ammoNames = {};
+		TStringArray boxNames = {};
+
+		bool success = file.Read(version) && version == EXPANSION_MARKET_AMMOBOX_CACHE_VERSION;
+		success = success && file.Read(hash) && hash == m_Expansion_MarketAddonsHash;
+		success = success && file.Read(ammoNames) && file.Read(boxNames) && ammoNames.Count() == boxNames.Count();
+
+		file.Close();
+
+		if (!success)
+			return false;
+
+		foreach (int i, string ammoName: ammoNames)
+		{
+			m_Expansion_MarketAmmoBoxes.Insert(ammoName, boxNames[i]);
+		}
+
+		return true;
+	}
+
+	protected void Expansion_SaveMarketAmmoBoxes()
+	{
+		if (!FileExist(EXPANSION_FOLDER))
+			ExpansionStatic.MakeDirectoryRecursive(EXPANSION_FOLDER);
+
+		FileSerializer file = new FileSerializer();
+		if (!file.Open(EXPANSION_MARKET_AMMOBOX_CACHE, FileMode.WRITE))
+		{
+			EXPrint(ToString() + " - could not write " + EXPANSION_MARKET_AMMOBOX_CACHE);
+			return;
+		}
+
+		file.Write(EXPANSION_MARKET_AMMOBOX_CACHE_VERSION);
+		file.Write(m_Expansion_MarketAddonsHash);
+		file.Write(m_Expansion_MarketAmmoBoxes.GetKeyArray());
+		file.Write(m_Expansion_MarketAmmoBoxes.GetValueArray());
+
+		file.Close();
+	}
+
+	//! Scans up to `batch` CfgVehicles entries, reschedules itself for the next frame until done
+	protected void Expansion_ScanMarketAmmoBoxes(int batch)
+	{
+		if (m_Expansion_MarketAmmoBoxesScanIndex < 0)
+			return;
+
+		int start = TickCount(0);
+		int count = ConfigGetChildrenCount(CFG_VEHICLESPATH);
+		int end = m_Expansion_MarketAmmoBoxesScanIndex + Math.Min(batch, count - m_Expansion_MarketAmmoBoxesScanIndex);
+
+		for (int i = m_Expansion_MarketAmmoBoxesScanIndex; i < end; i++)
 		{
 			string className;
 
@@ -51,12 +154,31 @@ modded class DayZGame
 			}
 		}
 
-		EXPrint(ToString() + " - found " + m_Expansion_MarketAmmoBoxes.Count() + " ammo boxes with corresponding ammo");
-	#endif
+		m_Expansion_MarketAmmoBoxesScanTicks += TickCount(start);
+
+		if (end < count)
+		{
+			m_Expansion_MarketAmmoBoxesScanIndex = end;
+			GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(Expansion_ScanMarketAmmoBoxes, 0, false, EXPANSION_MARKET_AMMOBOX_SCAN_BATCH);
+			return;
+		}
+
+		m_Expansion_MarketAmmoBoxesScanIndex = -1;
+
+		EXPrint(ToString() + " - enumerated " + count + " " + CFG_VEHICLESPATH + " entries, found " + m_Expansion_MarketAmmoBoxes.Count() + " ammo boxes with corresponding ammo (cache miss) in " + (m_Expansion_MarketAmmoBoxesScanTicks / 10000.0) + " ms");
+
+		Expansion_SaveMarketAmmoBoxes();
 	}
 
 	string Expansion_GetAmmoBoxByAmmoName(string name)
 	{
+		//! Background rebuild still in progress, finish it now so the result is complete
+		if (m_Expansion_MarketAmmoBoxesScanIndex >= 0)
+		{
+			GetCallQueue(CALL_CATEGORY_SYSTEM).Remove(Expansion_ScanMarketAmmoBoxes);
+			Expansion_ScanMarketAmmoBoxes(ConfigGetChildrenCount(CFG_VEHICLESPATH) - m_Expansion_MarketAmmoBoxesScanIndex);
+		}
+
 		return m_Expansion_MarketAmmoBoxes.Get(name);
 	}
 }
@@ -16,9 +16,14 @@ static const string EXPANSION_TRADER_ZONES_FOLDER = EXPANSION_MISSION_FOLDER + "
 static const string EXPANSION_TRADER_FOLDER = EXPANSION_FOLDER + "Traders\\";
 static const string EXPANSION_ATM_FOLDER = EXPANSION_FOLDER + "ATM\\";
 static const string EXPANSION_MARKET_SETTINGS = EXPANSION_MISSION_SETTINGS_FOLDER + "MarketSettings.json";
+static const string EXPANSION_MARKET_CATALOG_SNAPSHOT = EXPANSION_FOLDER + "MarketCatalog.bin";
+static const string EXPANSION_MARKET_VALIDATION_REPORT = EXPANSION_FOLDER + "MarketValidation.json";
+static const string EXPANSION_MARKET_MIGRATION_MANIFEST = EXPANSION_FOLDER + "MarketMigrations.bin";
 
 //! Client
 static const string EXPANSION_MARKET_PRESETS_FOLDER = EXPANSION_FOLDER + "MarketPresets\\";
 static const string EXPANSION_MARKET_WEAPON_PRESETS_FOLDER = EXPANSION_MARKET_PRESETS_FOLDER + "Weapons\\";
 static const string EXPANSION_MARKET_CLOTHING_PRESETS_FOLDER = EXPANSION_MARKET_PRESETS_FOLDER + "Clothing\\";
-static const string EXPANSION_MARKET_VESTS_PRESETS_FOLDER = EXPANSION_MARKET_CLOTHING_PRESETS_FOLDER + "Vests\\";
\ No newline at end of file
+static const string EXPANSION_MARKET_VESTS_PRESETS_FOLDER = EXPANSION_MARKET_CLOTHING_PRESETS_FOLDER + "Vests\\";
+static const string EXPANSION_MARKET_AMMOBOX_CACHE = EXPANSION_FOLDER + "MarketAmmoBoxes.bin";
+static const string EXPANSION_MARKET_CLIENT_CATALOG_FOLDER = EXPANSION_FOLDER + "MarketCatalogCache\\";
\ No newline at end of file
@@ -0,0 +1,381 @@
+/**
+ * ExpansionMarketCatalogSnapshot.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2024 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+/**@class		ExpansionMarketCatalogSnapshot
+ * @brief		Server. Binary snapshot of the market categories and traders as parsed (and converted) from JSON.
+ *
+ * Written after the JSON files were loaded, read on later boots instead of parsing JSON as long as the contents of all
+ * source files are unchanged. All strings are interned in one table, records are stored as one int and one float column.
+ * IDs, variants, default attachments and trader items are not part of the snapshot, they are set up again on load
+ * (see ExpansionMarketCategory::OnLoaded, ExpansionMarketTrader::OnLoaded) since they depend on load order and game config.
+ * Trader zones are always loaded from JSON, their files are saved with changed stock after every trade.
+ **/
+class ExpansionMarketCatalogSnapshot
+{
+	static const int VERSION = 2;
+
+	protected bool m_MarketSystemEnabled;
+	protected bool m_ATMSystemEnabled;
+	protected int m_Key;
+	protected bool m_IsLoaded;
+	protected bool m_IsDiscarded;
+
+	//! Source JSON files and hashes of their contents
+	protected ref TStringArray m_Files = new TStringArray;
+	protected ref TIntArray m_FileHashes = new TIntArray;
+
+	protected int m_CategoriesCount;
+	protected int m_TradersCount;
+
+	protected ref TStringArray m_Strings = new TStringArray;
+	protected ref map<string, int> m_StringIndices = new map<string, int>;
+
+	protected ref TIntArray m_Ints = new TIntArray;
+	protected ref TFloatArray m_Floats = new TFloatArray;
+	protected int m_IntIndex;
+	protected int m_FloatIndex;
+
+	void ExpansionMarketCatalogSnapshot(bool marketSystemEnabled, bool atmSystemEnabled)
+	{
+		m_MarketSystemEnabled = marketSystemEnabled;
+		m_ATMSystemEnabled = atmSystemEnabled;
+
+		//! Snapshot is stale whenever enabled systems or any file format version change
+		m_Key = marketSystemEnabled + 2 * atmSystemEnabled;
+		m_Key = m_Key * 31 + ExpansionMarketCategory.VERSION;
+		m_Key = m_Key * 31 + ExpansionMarketTrader.VERSION;
+	}
+
+	//! @return true if snapshot exists and matches the current JSON files, records can then be read in the order they were written
+	bool Load()
+	{
+		if (!FileExist(EXPANSION_MARKET_CATALOG_SNAPSHOT))
+			return false;
+
+		FileSerializer file = new FileSerializer();
+		if (!file.Open(EXPANSION_MARKET_CATALOG_SNAPSHOT, FileMode.READ))
+			return false;
+
+		int version;
+		int key;
+
+		bool success = file.Read(version) && version == VERSION;
+		success = success && file.Read(key) && key == m_Key;
+		success = success && file.Read(m_Files) && file.Read(m_FileHashes) && IsCurrent();
+		success = success && file.Read(m_CategoriesCount) && file.Read(m_TradersCount);
+		success = success && file.Read(m_Strings) && file.Read(m_Ints) && file.Read(m_Floats);
+
+		file.Close();
+
+		m_IsLoaded = success;
+
+		return success;
+	}
+
+	void Save()
+	{
+		if (m_IsDiscarded)
+		{
+			EXPrint(ToString() + "::Save - Not writing " + EXPANSION_MARKET_CATALOG_SNAPSHOT + ", files were created or converted during load");
+			return;
+		}
+
+		GetSourceFiles(m_Files, m_FileHashes);
+
+		FileSerializer file = new FileSerializer();
+		if (!file.Open(EXPANSION_MARKET_CATALOG_SNAPSHOT, FileMode.WRITE))
+		{
+			EXPrint(ToString() + "::Save - Could not write " + EXPANSION_MARKET_CATALOG_SNAPSHOT);
+			return;
+		}
+
+		file.Write(VERSION);
+		file.Write(m_Key);
+		file.Write(m_Files);
+		file.Write(m_FileHashes);
+		file.Write(m_CategoriesCount);
+		file.Write(m_TradersCount);
+		file.Write(m_Strings);
+		file.Write(m_Ints);
+		file.Write(m_Floats);
+
+		file.Close();
+	}
+
+	//! Records of this load can't be reproduced from the JSON files as they are now (defaults created, old formats converted)
+	void Discard()
+	{
+		m_IsDiscarded = true;
+	}
+
+	bool IsLoaded()
+	{
+		return m_IsLoaded;
+	}
+
+	int GetCategoriesCount()
+	{
+		return m_CategoriesCount;
+	}
+
+	int GetTradersCount()
+	{
+		return m_TradersCount;
+	}
+
+	string ToDebugString()
+	{
+		return m_Files.Count() + " files, " + m_CategoriesCount + " categories, " + m_TradersCount + " traders, " + m_Strings.Count() + " strings";
+	}
+
+	void WriteCategory(ExpansionMarketCategory category)
+	{
+		WriteString(category.m_FileName);
+		WriteInt(category.m_Version);
+		WriteString(category.DisplayName);
+		WriteString(category.Icon);
+		WriteString(category.Color);
+		WriteInt(category.IsExchange);
+		WriteFloat(category.InitStockPercent);
+
+		WriteInt(category.Items.Count());
+		foreach (ExpansionMarketItem item: category.Items)
+		{
+			WriteString(item.ClassName);
+			WriteInt(item.MaxPriceThreshold);
+			WriteInt(item.MinPriceThreshold);
+			WriteFloat(item.SellPricePercent);
+			WriteInt(item.MaxStockThreshold);
+			WriteInt(item.MinStockThreshold);
+			WriteInt(item.QuantityPercent);
+			WriteStrings(item.SpawnAttachments);
+			WriteStrings(item.Variants);
+		}
+
+		m_CategoriesCount++;
+	}
+
+	ExpansionMarketCategory ReadCategory()
+	{
+		ExpansionMarketCategory category = new ExpansionMarketCategory;
+		category.m_FileName = ReadString();
+		category.m_Version = ReadInt();
+		category.DisplayName = ReadString();
+		category.Icon = ReadString();
+		category.Color = ReadString();
+		category.IsExchange = ReadInt();
+		category.InitStockPercent = ReadFloat();
+
+		int count = ReadInt();
+		for (int i = 0; i < count; i++)
+		{
+			string className = ReadString();
+			int maxPrice = ReadInt();
+			int minPrice = ReadInt();
+			float sellPricePercent = ReadFloat();
+			int maxStock = ReadInt();
+			int minStock = ReadInt();
+			int quantityPercent = ReadInt();
+
+			//! NOTE: ItemID and CategoryID are assigned in OnLoaded, same as for items loaded from JSON
+			ExpansionMarketItem item = new ExpansionMarketItem(0, className, minPrice, maxPrice, minStock, maxStock, null, null, sellPricePercent, quantityPercent, 0);
+			item.SpawnAttachments = ReadStrings();
+			item.Variants = ReadStrings();
+
+			category.Items.Insert(item);
+		}
+
+		category.OnLoaded();
+
+		return category;
+	}
+
+	void WriteTrader(ExpansionMarketTrader trader)
+	{
+		WriteString(trader.m_FileName);
+		WriteInt(trader.m_Version);
+		WriteString(trader.DisplayName);
+		WriteInt(trader.MinRequiredReputation);
+		WriteInt(trader.MaxRequiredReputation);
+		WriteString(trader.RequiredFaction);
+		WriteInt(trader.RequiredCompletedQuestID);
+		WriteString(trader.TraderIcon);
+		WriteStrings(trader.Currencies);
+		WriteInt(trader.DisplayCurrencyValue);
+		WriteString(trader.DisplayCurrencyName);
+		WriteStrings(trader.Categories);
+
+		WriteInt(trader.Items.Count());
+		foreach (string className, ExpansionMarketTraderBuySell buySell: trader.Items)
+		{
+			WriteString(className);
+			WriteInt(buySell);
+		}
+
+		m_TradersCount++;
+	}
+
+	ExpansionMarketTrader ReadTrader()
+	{
+		ExpansionMarketTrader trader = new ExpansionMarketTrader;
+		trader.m_FileName = ReadString();
+		trader.m_Version = ReadInt();
+		trader.DisplayName = ReadString();
+		trader.MinRequiredReputation = ReadInt();
+		trader.MaxRequiredReputation = ReadInt();
+		trader.RequiredFaction = ReadString();
+		trader.RequiredCompletedQuestID = ReadInt();
+		trader.TraderIcon = ReadString();
+		trader.Currencies = ReadStrings();
+		trader.DisplayCurrencyValue = ReadInt();
+		trader.DisplayCurrencyName = ReadString();
+		trader.Categories = ReadStrings();
+
+		int count = ReadInt();
+		for (int i = 0; i < count; i++)
+		{
+			string className = ReadString();
+			trader.Items.Insert(className, ReadInt());
+		}
+
+		trader.OnLoaded();
+
+		return trader;
+	}
+
+	//! @return true if the JSON files and their contents are the same as when the snapshot was written
+	protected bool IsCurrent()
+	{
+		TStringArray files = new TStringArray;
+		TIntArray hashes = new TIntArray;
+
+		GetSourceFiles(files, hashes);
+
+		if (files.Count() != m_Files.Count() || hashes.Count() != m_FileHashes.Count())
+			return false;
+
+		foreach (int i, string fileName: files)
+		{
+			if (fileName != m_Files[i] || hashes[i] != m_FileHashes[i])
+				return false;
+		}
+
+		return true;
+	}
+
+	protected void GetSourceFiles(TStringArray files, TIntArray hashes)
+	{
+		files.Clear();
+		hashes.Clear();
+
+		if (m_MarketSystemEnabled || m_ATMSystemEnabled)
+			AddSourceFiles(EXPANSION_MARKET_FOLDER, files, hashes);
+
+		if (m_MarketSystemEnabled)
+			AddSourceFiles(EXPANSION_TRADER_FOLDER, files, hashes);
+	}
+
+	protected void AddSourceFiles(string folder, TStringArray files, TIntArray hashes)
+	{
+		array<string> fileNames = ExpansionStatic.FindFilesInLocation(folder, ".json", true);
+
+		foreach (string fileName: fileNames)
+		{
+			files.Insert(folder + fileName);
+			hashes.Insert(GetFileHash(folder + fileName));
+		}
+	}
+
+	//! File modification time and size are not available to script, so source files are compared by a hash of their contents
+	static int GetFileHash(string path)
+	{
+		FileHandle file = OpenFile(path, FileMode.READ);
+		if (!file)
+			return 0;
+
+		int hash;
+		string line;
+		while (FGets(file, line) >= 0)
+		{
+			hash = hash * 31 + line.Hash();
+		}
+
+		CloseFile(file);
+
+		return hash;
+	}
+
+	protected void WriteInt(int value)
+	{
+		m_Ints.Insert(value);
+	}
+
+	protected int ReadInt()
+	{
+		return m_Ints[m_IntIndex++];
+	}
+
+	protected void WriteFloat(float value)
+	{
+		m_Floats.Insert(value);
+	}
+
+	protected float ReadFloat()
+	{
+		return m_Floats[m_FloatIndex++];
+	}
+
+	protected void WriteString(string value)
+	{
+		int index;
+		if (!m_StringIndices.Find(value, index))
+		{
+			index = m_Strings.Insert(value);
+			m_StringIndices.Insert(value, index);
+		}
+
+		m_Ints.Insert(index);
+	}
+
+	protected string ReadString()
+	{
+		return m_Strings[ReadInt()];
+	}
+
+	protected void WriteStrings(TStringArray values)
+	{
+		if (!values)
+		{
+			m_Ints.Insert(0);
+			return;
+		}
+
+		m_Ints.Insert(values.Count());
+		foreach (string value: values)
+		{
+			WriteString(value);
+		}
+	}
+
+	protected TStringArray ReadStrings()
+	{
+		TStringArray values = new TStringArray;
+
+		int count = ReadInt();
+		for (int i = 0; i < count; i++)
+		{
+			values.Insert(ReadString());
+		}
+
+		return values;
+	}
+}
@@ -51,17 +51,36 @@ class ExpansionMarketCategory
 
 	[NonSerialized()]
 	int m_Idx;
+
+	//! Variant -> parent, for variants that were not added because they already exist in another category (see ExpansionMarketValidator)
+	[NonSerialized()]
+	ref map<string, string> m_UnreachableVariants = new map<string, string>;
 	
 	// ------------------------------------------------------------
 	// Expansion ExpansionMarketCategory Load
 	// ------------------------------------------------------------
-	static ExpansionMarketCategory Load(string name)
+	static ExpansionMarketCategory Load(string name, ExpansionMarketCatalogSnapshot snapshot = null)
 	{
-		ExpansionMarketCategory categoryDefault = new ExpansionMarketCategory;
-		categoryDefault.Defaults();
+		ExpansionMarketCategory category = Parse(name);
+		if (!category)
+			return NULL;
+
+		//! Record as loaded, before IDs are assigned and variants are added
+		if (snapshot)
+			snapshot.WriteCategory(category);
+
+		category.OnLoaded();
+
+		return category;
+	}
+
+	//! Loads category from JSON and converts it to the current version. IDs are not assigned and items are not added yet (see OnLoaded)
+	static ExpansionMarketCategory Parse(string name)
+	{
+		string path = EXPANSION_MARKET_FOLDER + name + ".json";
 
 		ExpansionMarketCategory category = new ExpansionMarketCategory;
-		if (!ExpansionJsonFileParser<ExpansionMarketCategory>.Load( EXPANSION_MARKET_FOLDER + name + ".json", category ))
+		if (!ExpansionJsonFileParser<ExpansionMarketCategory>.Load( path, category ))
 			return NULL;
 
 		category.m_FileName = name;
@@ -70,61 +89,54 @@ class ExpansionMarketCategory
 		{
 			EXPrint("[ExpansionMarketCategory] Load - Converting v" + category.m_Version + " \"" + name + ".json\" to v" + VERSION);
 
-			if (category.m_Version < 5)
-			{
-				category.Icon = categoryDefault.Icon;
-				category.Color = categoryDefault.Color;
-			}
+			if (!GetMigrations().Run(category, path, category.m_Version))
+				return NULL;
 
-			if (category.m_Version < 7)
-			{
-				foreach (ExpansionMarketItem itemV6OrLower : category.Items)
-				{
-					if (!itemV6OrLower.SellPricePercent)
-						itemV6OrLower.SellPricePercent = -1;
-				}
-			}
-
-			if (category.m_Version < 8)
-				category.InitStockPercent = categoryDefault.InitStockPercent;
+			category.m_Version = VERSION;
+			ExpansionMarketMigrationWriter<ExpansionMarketCategory>.Save(path, category);
+		}
 
-			if (category.m_Version < 9)
-			{
-				foreach (ExpansionMarketItem itemV8OrLower : category.Items)
-				{
-					if (!itemV8OrLower.QuantityPercent)
-						itemV8OrLower.QuantityPercent = -1;
-				}
-			}
+		return category;
+	}
 
-			if (category.m_Version < 12)
-			{
-				string fileNameLower = name;
-				fileNameLower.ToLower();
-				category.IsExchange = fileNameLower.IndexOf("exchange") == 0;
-			}
+	protected static ref ExpansionMarketMigrationPipeline s_Migrations;
 
-			category.m_Version = VERSION;
-			category.Save();
+	static ExpansionMarketMigrationPipeline GetMigrations()
+	{
+		if (!s_Migrations)
+		{
+			s_Migrations = new ExpansionMarketMigrationPipeline;
+			s_Migrations.Register(5, new ExpansionMarketCategoryMigrationV5);
+			s_Migrations.Register(7, new ExpansionMarketCategoryMigrationV7);
+			s_Migrations.Register(8, new ExpansionMarketCategoryMigrationV8);
+			s_Migrations.Register(9, new ExpansionMarketCategoryMigrationV9);
+			s_Migrations.Register(12, new ExpansionMarketCategoryMigrationV12);
 		}
 
-		if (!m_CategoryIDs.Contains(name))
-			m_CategoryIDs.Insert(name, m_CategoryIDs.Count() + 1);
+		return s_Migrations;
+	}
+
+	//! Assigns category and item IDs, removes duplicates and finalizes the category.
+	//! Called after loading from JSON or catalog snapshot (see ExpansionMarketCatalogSnapshot)
+	void OnLoaded()
+	{
+		if (!m_CategoryIDs.Contains(m_FileName))
+			m_CategoryIDs.Insert(m_FileName, m_CategoryIDs.Count() + 1);
 
-		category.CategoryID = m_CategoryIDs.Get(name);
+		CategoryID = m_CategoryIDs.Get(m_FileName);
 		
 		//! Make sure we have no duplicates
 		array<ref ExpansionMarketItem> items = new array<ref ExpansionMarketItem>;
-		foreach (ExpansionMarketItem currentItem : category.Items)
+		foreach (ExpansionMarketItem currentItem : Items)
 		{
 			//! Make sure item classnames are lowercase
-			currentItem.ClassName.ToLower();
+			currentItem.ClassName = ExpansionMarketClassName.Normalize(currentItem.ClassName);
 
-			if (!category.CheckDuplicate(currentItem.ClassName))
+			if (!CheckDuplicate(currentItem.ClassName))
 				items.Insert(currentItem);
 		}
 
-		category.Items.Clear();
+		Items.Clear();
 
 		foreach (ExpansionMarketItem item : items)
 		{
@@ -132,31 +144,129 @@ class ExpansionMarketCategory
 			item.ItemID = ++ExpansionMarketItem.m_CurrentItemId;
 
 			//! NOTE: CategoryID is not serialized for the item, so always assign it from containing category!
-			item.CategoryID = category.CategoryID;
+			item.CategoryID = CategoryID;
+
+			item.SetSpawnAttachments(item.SpawnAttachments);
+
+			item.SanityCheckAndRepair();
+
+			AddItemInternal( item );
+		}
+
+		Finalize();
+	}
+	
+	//! Server. Applies a changed category file (parsed but not loaded, see Parse) to this category in place.
+	//! Items that still exist keep their ID, removed items are dropped from the global item maps, new items get new IDs.
+	//! Variants and default attachments are added again for all items.
+	void Reload(ExpansionMarketCategory source, out int added, out int removed, out int modified)
+	{
+		m_Version = source.m_Version;
+		DisplayName = source.DisplayName;
+		Icon = source.Icon;
+		Color = source.Color;
+		IsExchange = source.IsExchange;
+		InitStockPercent = source.InitStockPercent;
+
+		map<string, ExpansionMarketItem> sourceItems = new map<string, ExpansionMarketItem>;
+		array<ExpansionMarketItem> newItems = new array<ExpansionMarketItem>;
+		ExpansionMarketItem existing;
+		foreach (ExpansionMarketItem sourceItem : source.Items)
+		{
+			existing = null;
 
-			//! Make sure attachment classnames are lowercase
-			TStringArray attachments = item.SpawnAttachments;
-			item.SpawnAttachments = new TStringArray;
-			foreach (string attachment : attachments)
+			sourceItem.ClassName = ExpansionMarketClassName.Normalize(sourceItem.ClassName);
+
+			if (sourceItems.Contains(sourceItem.ClassName))
 			{
-				attachment.ToLower();
-				//! Check if attachment is not same classname as parent to prevent infinite recursion (user error)
-				if (attachment == item.ClassName)
-					Error("[ExpansionMarketItem] Trying to add " + item.ClassName + " as attachment to itself!");
-				else
-					item.SpawnAttachments.Insert(attachment);
+				Error("Item " + sourceItem.ClassName + " has already been added to category " + m_FileName + " (ID " + CategoryID + ")");
+				continue;
 			}
 
-			item.SanityCheckAndRepair();
+			if (!m_Items.Find(sourceItem.ClassName, existing) || existing.m_StockOnly)
+			{
+				//! Items of other categories can't be added to this one (stock only variants of this category are re-added below)
+				if (!existing && CheckDuplicate(sourceItem.ClassName))
+					continue;
+
+				newItems.Insert(sourceItem);
+			}
 
-			category.AddItemInternal( item );
+			sourceItems.Insert(sourceItem.ClassName, sourceItem);
 		}
 
-		category.Finalize();
+		//! Stock only variants are always added again by Finalize, they copy their settings from the parent item
+		array<ExpansionMarketItem> toRemove = new array<ExpansionMarketItem>;
+		foreach (string className, ExpansionMarketItem item : m_Items)
+		{
+			if (item.m_StockOnly)
+			{
+				toRemove.Insert(item);
+				continue;
+			}
 
-		return category;
+			item.m_IsVariant = false;
+			item.m_Parent = null;
+
+			if (!sourceItems.Contains(className))
+			{
+				toRemove.Insert(item);
+				removed++;
+			}
+			else if (item.Update(sourceItems[className]))
+			{
+				modified++;
+			}
+		}
+
+		foreach (ExpansionMarketItem itemToRemove : toRemove)
+		{
+			RemoveItemInternal(itemToRemove);
+		}
+
+		foreach (ExpansionMarketItem newItem : newItems)
+		{
+			newItem.ItemID = ++ExpansionMarketItem.m_CurrentItemId;
+			newItem.CategoryID = CategoryID;
+			newItem.SetSpawnAttachments(newItem.SpawnAttachments);
+			newItem.SanityCheckAndRepair();
+
+			AddItemInternal(newItem);
+			added++;
+		}
+
+		Finalize();
 	}
-	
+
+	//! Removes all items of this category, also from the global item maps (category file was removed or changed)
+	void Unload()
+	{
+		foreach (ExpansionMarketItem item : m_Items)
+		{
+			s_GlobalItems.Remove(item.ClassName);
+			s_GlobalItemsByID.Remove(item.ItemID);
+		}
+
+		Items.Clear();
+		m_Items.Clear();
+		m_ItemsByID.Clear();
+		m_HasItems = false;
+	}
+
+	protected void RemoveItemInternal(ExpansionMarketItem item)
+	{
+		int index = Items.Find(item);
+		if (index > -1)
+			Items.RemoveOrdered(index);
+
+		m_Items.Remove(item.ClassName);
+		m_ItemsByID.Remove(item.ItemID);
+		s_GlobalItems.Remove(item.ClassName);
+		s_GlobalItemsByID.Remove(item.ItemID);
+
+		m_HasItems = m_Items.Count() > 0;
+	}
+
 	// ------------------------------------------------------------
 	// Expansion Save
 	// ------------------------------------------------------------
@@ -187,7 +297,7 @@ class ExpansionMarketCategory
 	// ------------------------------------------------------------
 	ExpansionMarketItem AddItem( string className, int minPrice, int maxPrice, int minStock, int maxStock, array< string > attachments = NULL, array< string > variants = NULL, float sellPricePercent = -1, int quantityPercent = -1, int itemID = -1, array<int> attachmentIDs = NULL )
 	{
-		className.ToLower();
+		className = ExpansionMarketClassName.Normalize(className);
 
 		if (ExpansionGame.IsServerOrOffline() && CheckDuplicate(className))
 			return NULL;
@@ -268,12 +378,15 @@ class ExpansionMarketCategory
 			item.Variants = new TStringArray;
 			foreach (string className : variants)
 			{
-				className.ToLower();
+				className = ExpansionMarketClassName.Normalize(className);
 				ExpansionMarketItem variant;
 				if (!m_Items.Find(className, variant))
 				{
 					if (ExpansionGame.IsServerOrOffline() && CheckDuplicate(className))
+					{
+						m_UnreachableVariants.Set(className, item.ClassName);
 						continue;
+					}
 
 					if (variantIds)
 						variantId = variantIds[variantIdIdx];
@@ -379,4 +492,81 @@ class ExpansionMarketCategory
 		CategoryID = cat.CategoryID;
 		IsExchange = cat.IsExchange;
 	}
-}
\ No newline at end of file
+}
+
+class ExpansionMarketCategoryMigrationV5: ExpansionMarketMigrationStep
+{
+	override bool Apply(Class settings, string path, int fromVersion)
+	{
+		ExpansionMarketCategory category = ExpansionMarketCategory.Cast(settings);
+
+		ExpansionMarketCategory categoryDefault = new ExpansionMarketCategory;
+		categoryDefault.Defaults();
+
+		category.Icon = categoryDefault.Icon;
+		category.Color = categoryDefault.Color;
+
+		return true;
+	}
+}
+
+class ExpansionMarketCategoryMigrationV7: ExpansionMarketMigrationStep
+{
+	override bool Apply(Class settings, string path, int fromVersion)
+	{
+		ExpansionMarketCategory category = ExpansionMarketCategory.Cast(settings);
+
+		foreach (ExpansionMarketItem item : category.Items)
+		{
+			if (!item.SellPricePercent)
+				item.SellPricePercent = -1;
+		}
+
+		return true;
+	}
+}
+
+class ExpansionMarketCategoryMigrationV8: ExpansionMarketMigrationStep
+{
+	override bool Apply(Class settings, string path, int fromVersion)
+	{
+		ExpansionMarketCategory category = ExpansionMarketCategory.Cast(settings);
+
+		ExpansionMarketCategory categoryDefault = new ExpansionMarketCategory;
+		categoryDefault.Defaults();
+
+		category.InitStockPercent = categoryDefault.InitStockPercent;
+
+		return true;
+	}
+}
+
+class ExpansionMarketCategoryMigrationV9: ExpansionMarketMigrationStep
+{
+	override bool Apply(Class settings, string path, int fromVersion)
+	{
+		ExpansionMarketCategory category = ExpansionMarketCategory.Cast(settings);
+
+		foreach (ExpansionMarketItem item : category.Items)
+		{
+			if (!item.QuantityPercent)
+				item.QuantityPercent = -1;
+		}
+
+		return true;
+	}
+}
+
+class ExpansionMarketCategoryMigrationV12: ExpansionMarketMigrationStep
+{
+	override bool Apply(Class settings, string path, int fromVersion)
+	{
+		ExpansionMarketCategory category = ExpansionMarketCategory.Cast(settings);
+
+		string fileNameLower = category.m_FileName;
+		fileNameLower.ToLower();
+		category.IsExchange = fileNameLower.IndexOf("exchange") == 0;
+
+		return true;
+	}
+}
@@ -0,0 +1,58 @@
+/**
+ * ExpansionMarketClassName.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2024 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+/**@class		ExpansionMarketClassName
+ * @brief		Interned lowercase classnames, as used for all market lookups (items, trader items, stock).
+ *
+ * Classnames coming in from settings files, the network or EntityAI::GetType are normalized here instead of calling ToLower at every use.
+ * Each spelling of a classname is only lowercased the first time it is seen, after that it resolves to the same ID with a single map lookup.
+ **/
+class ExpansionMarketClassName
+{
+	//! Any spelling seen so far (as is and lowercase) -> ID
+	protected static ref map<string, int> s_IDs = new map<string, int>;
+
+	//! ID -> lowercase classname
+	protected static ref TStringArray s_Names = new TStringArray;
+
+	static int GetID(string className)
+	{
+		int id;
+		if (s_IDs.Find(className, id))
+			return id;
+
+		string lower = className;
+		lower.ToLower();
+
+		if (!s_IDs.Find(lower, id))
+		{
+			id = s_Names.Insert(lower);
+			s_IDs.Insert(lower, id);
+		}
+
+		if (lower != className)
+			s_IDs.Insert(className, id);
+
+		return id;
+	}
+
+	static string Get(int id)
+	{
+		return s_Names[id];
+	}
+
+	//! @return lowercase classname
+	static string Normalize(string className)
+	{
+		return s_Names[GetID(className)];
+	}
+}
@@ -73,6 +73,12 @@ class ExpansionMarketItem
 
 	[NonSerialized()]
 	bool m_UpdateView;
+
+	//! Min and max thresholds as loaded, if max had to be raised to min (see SanityCheckAndRepair, reported by ExpansionMarketValidator)
+	[NonSerialized()]
+	ref TIntArray m_InvertedPriceThresholds;
+	[NonSerialized()]
+	ref TIntArray m_InvertedStockThresholds;
 	
 #ifdef EXPANSIONMODHARDLINE
 	[NonSerialized()]
@@ -91,8 +97,7 @@ class ExpansionMarketItem
 
 		CategoryID = catID;
 		
-		ClassName = className;
-		ClassName.ToLower();
+		ClassName = ExpansionMarketClassName.Normalize(className);
 
 		MinPriceThreshold = minPrice;
 		MaxPriceThreshold = maxPrice;
@@ -109,7 +114,7 @@ class ExpansionMarketItem
 		{
 			foreach ( string attClsName : attachments )
 			{
-				attClsName.ToLower();
+				attClsName = ExpansionMarketClassName.Normalize(attClsName);
 				//! Check if attachment is not same classname as parent to prevent infinite recursion (user error)
 				if (attClsName == ClassName)
 					Error("[ExpansionMarketItem] Trying to add " + ClassName + " as attachment to itself!");
@@ -123,7 +128,7 @@ class ExpansionMarketItem
 		{
 			foreach ( string variantClsName : variants )
 			{
-				variantClsName.ToLower();
+				variantClsName = ExpansionMarketClassName.Normalize(variantClsName);
 				Variants.Insert( variantClsName );
 			}
 		}
@@ -151,12 +156,14 @@ class ExpansionMarketItem
 		if ( MinPriceThreshold > MaxPriceThreshold )
 		{
 			Error("[ExpansionMarketItem] The minimum price must be lower than or equal to the maximum price for '" + ClassName + "'");
+			m_InvertedPriceThresholds = {MinPriceThreshold, MaxPriceThreshold};
 			MaxPriceThreshold = MinPriceThreshold;
 		}
 
 		if ( MinStockThreshold > MaxStockThreshold )
 		{
 			Error("[ExpansionMarketItem] The minimum stock must be lower than or equal to the maximum stock for '" + ClassName + "'");
+			m_InvertedStockThresholds = {MinStockThreshold, MaxStockThreshold};
 			MaxStockThreshold = MinStockThreshold;
 		}
 
@@ -177,6 +184,86 @@ class ExpansionMarketItem
 #endif
 	}
 
+	//! Sets spawn attachments, making sure class names are lowercase
+	void SetSpawnAttachments(TStringArray attachments)
+	{
+		SpawnAttachments = new TStringArray;
+
+		if (!attachments)
+			return;
+
+		foreach (string attachment : attachments)
+		{
+			attachment.ToLower();
+			//! Check if attachment is not same classname as parent to prevent infinite recursion (user error)
+			if (attachment == ClassName)
+				Error("[ExpansionMarketItem] Trying to add " + ClassName + " as attachment to itself!");
+			else
+				SpawnAttachments.Insert(attachment);
+		}
+	}
+
+	//! Server. Copies settings from `source` (same class name, e.g. from a changed category file).
+	//! @return true if any setting changed
+	bool Update(ExpansionMarketItem source)
+	{
+		int maxPrice = MaxPriceThreshold;
+		int minPrice = MinPriceThreshold;
+		int sellPricePercent = m_SellPricePercent;
+		int maxStock = MaxStockThreshold;
+		int minStock = MinStockThreshold;
+		int quantityPercent = QuantityPercent;
+		TStringArray attachments = SpawnAttachments;
+		TStringArray variants = Variants;
+
+		MaxPriceThreshold = source.MaxPriceThreshold;
+		MinPriceThreshold = source.MinPriceThreshold;
+		SellPricePercent = source.SellPricePercent;
+		MaxStockThreshold = source.MaxStockThreshold;
+		MinStockThreshold = source.MinStockThreshold;
+		QuantityPercent = source.QuantityPercent;
+
+		m_InvertedPriceThresholds = source.m_InvertedPriceThresholds;
+		m_InvertedStockThresholds = source.m_InvertedStockThresholds;
+
+		SetSpawnAttachments(source.SpawnAttachments);
+
+		Variants = new TStringArray;
+		if (source.Variants)
+			Variants.Copy(source.Variants);
+
+		SanityCheckAndRepair();
+
+		if (MaxPriceThreshold != maxPrice || MinPriceThreshold != minPrice || m_SellPricePercent != sellPricePercent)
+			return true;
+
+		if (MaxStockThreshold != maxStock || MinStockThreshold != minStock || QuantityPercent != quantityPercent)
+			return true;
+
+		//! Items without configured attachments got default attachments when finalized (see AddDefaultAttachments), these don't count as change
+		if (!IsEqual(SpawnAttachments, attachments) && SpawnAttachments.Count())
+			return true;
+
+		return !IsEqual(Variants, variants);
+	}
+
+	protected static bool IsEqual(TStringArray a, TStringArray b)
+	{
+		if (a.Count() != b.Count())
+			return false;
+
+		foreach (int i, string value : a)
+		{
+			string other = b[i];
+			other.ToLower();
+			value.ToLower();
+			if (value != other)
+				return false;
+		}
+
+		return true;
+	}
+
 	void SetAttachmentsFromIDs()
 	{
 		SpawnAttachments.Clear();
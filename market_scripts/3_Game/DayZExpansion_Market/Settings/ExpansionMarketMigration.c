@@ -0,0 +1,205 @@
+/**
+ * ExpansionMarketMigration.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2024 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+//! One upgrade step of a settings file to the version it is registered for (see ExpansionMarketMigrationPipeline::Register)
+class ExpansionMarketMigrationStep
+{
+	int m_ToVersion;
+
+	//! @param settings     Settings loaded from `path` as current class
+	//! @param fromVersion  Version of the file as loaded, before any step was applied
+	//! @return false if settings could not be upgraded
+	bool Apply(Class settings, string path, int fromVersion)
+	{
+		return true;
+	}
+}
+
+//! Upgrade steps of one settings class, applied in order of version
+class ExpansionMarketMigrationPipeline
+{
+	protected ref array<ref ExpansionMarketMigrationStep> m_Steps = new array<ref ExpansionMarketMigrationStep>;
+
+	void Register(int toVersion, ExpansionMarketMigrationStep step)
+	{
+		step.m_ToVersion = toVersion;
+
+		for (int i = 0; i < m_Steps.Count(); i++)
+		{
+			if (m_Steps[i].m_ToVersion > toVersion)
+				break;
+		}
+
+		m_Steps.InsertAt(step, i);
+	}
+
+	//! Applies all steps to a version above `fromVersion`
+	bool Run(Class settings, string path, int fromVersion)
+	{
+		foreach (ExpansionMarketMigrationStep step : m_Steps)
+		{
+			if (step.m_ToVersion <= fromVersion)
+				continue;
+
+			if (!step.Apply(settings, path, fromVersion))
+			{
+				Error("ExpansionMarketMigrationPipeline::Run - Could not upgrade \"" + path + "\" from v" + fromVersion + " to v" + step.m_ToVersion);
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+//! Writes upgraded settings to a temporary file first and only replaces the original file once the written file can be parsed again.
+//! The original file is kept as .bak until the replaced file could be parsed, and restored from it otherwise.
+class ExpansionMarketMigrationWriter<Class T>
+{
+	static bool Save(string path, T settings)
+	{
+		string tmpPath = path + ".tmp";
+		string bakPath = path + ".bak";
+
+		JsonFileLoader<T>.JsonSaveFile(tmpPath, settings);
+
+		T written;
+		if (!ExpansionJsonFileParser<T>.Load(tmpPath, written))
+		{
+			Error("ExpansionMarketMigrationWriter::Save - Could not write upgraded \"" + path + "\", keeping original file");
+			DeleteFile(tmpPath);
+			return false;
+		}
+
+		if (FileExist(bakPath))
+			DeleteFile(bakPath);
+
+		if (!CopyFile(path, bakPath))
+		{
+			Error("ExpansionMarketMigrationWriter::Save - Could not back up \"" + path + "\" to \"" + bakPath + "\", keeping original file");
+			DeleteFile(tmpPath);
+			return false;
+		}
+
+		//! CopyFile does not overwrite existing files
+		DeleteFile(path);
+
+		T replaced;
+		if (!CopyFile(tmpPath, path) || !ExpansionJsonFileParser<T>.Load(path, replaced))
+		{
+			Error("ExpansionMarketMigrationWriter::Save - Could not replace \"" + path + "\" with upgraded file, restoring from \"" + bakPath + "\"");
+
+			if (FileExist(path))
+				DeleteFile(path);
+
+			if (CopyFile(bakPath, path))
+				DeleteFile(bakPath);
+			else
+				Error("ExpansionMarketMigrationWriter::Save - Could not restore \"" + path + "\", original file is kept as \"" + bakPath + "\"");
+
+			DeleteFile(tmpPath);
+			return false;
+		}
+
+		DeleteFile(tmpPath);
+		DeleteFile(bakPath);
+
+		return true;
+	}
+}
+
+//! Server only. Trader file path -> version the file was last loaded or upgraded at.
+//! Files recorded at the current version are parsed once with the current class instead of probing their version first (see ExpansionMarketTrader::Load).
+//! Category and trader zone files are always parsed with the current class first, so they are not recorded.
+class ExpansionMarketMigrationManifest
+{
+	static const int VERSION = 1;
+
+	protected static ref ExpansionMarketMigrationManifest s_Instance;
+
+	protected ref map<string, int> m_Versions = new map<string, int>;
+	protected bool m_IsDirty;
+
+	static ExpansionMarketMigrationManifest Get()
+	{
+		if (!s_Instance)
+		{
+			s_Instance = new ExpansionMarketMigrationManifest;
+			s_Instance.Load();
+		}
+
+		return s_Instance;
+	}
+
+	protected void Load()
+	{
+		if (!FileExist(EXPANSION_MARKET_MIGRATION_MANIFEST))
+			return;
+
+		FileSerializer file = new FileSerializer();
+		if (!file.Open(EXPANSION_MARKET_MIGRATION_MANIFEST, FileMode.READ))
+			return;
+
+		int version;
+		TStringArray paths;
+		TIntArray versions;
+
+		bool success = file.Read(version) && version == VERSION;
+		success = success && file.Read(paths) && file.Read(versions) && paths.Count() == versions.Count();
+
+		file.Close();
+
+		if (!success)
+			return;
+
+		foreach (int i, string path : paths)
+		{
+			m_Versions.Insert(path, versions[i]);
+		}
+	}
+
+	void Save()
+	{
+		if (!m_IsDirty)
+			return;
+
+		FileSerializer file = new FileSerializer();
+		if (!file.Open(EXPANSION_MARKET_MIGRATION_MANIFEST, FileMode.WRITE))
+		{
+			EXPrint(ToString() + "::Save - could not write " + EXPANSION_MARKET_MIGRATION_MANIFEST);
+			return;
+		}
+
+		file.Write(VERSION);
+		file.Write(m_Versions.GetKeyArray());
+		file.Write(m_Versions.GetValueArray());
+
+		file.Close();
+
+		m_IsDirty = false;
+	}
+
+	bool IsCurrent(string path, int version)
+	{
+		return m_Versions.Get(path) == version;
+	}
+
+	void SetVersion(string path, int version)
+	{
+		int previous;
+		if (m_Versions.Find(path, previous) && previous == version)
+			return;
+
+		m_Versions.Set(path, version);
+		m_IsDirty = true;
+	}
+}
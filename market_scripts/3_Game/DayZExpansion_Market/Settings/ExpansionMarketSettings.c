@@ -104,6 +104,14 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 	protected autoptr array<ref ExpansionMarketTraderZone> m_TraderZones;
 	[NonSerialized()]
 	protected autoptr array<ref ExpansionMarketTrader> m_Traders;
+	//! Lowercase file name -> category/trader
+	[NonSerialized()]
+	protected autoptr map<string, ExpansionMarketCategory> m_CategoriesByFileName;
+	[NonSerialized()]
+	protected autoptr map<string, ExpansionMarketTrader> m_TradersByFileName;
+	//! Lowercase classnames of LargeVehicles (see GetMinVehicleDistanceToTrader/GetMaxVehicleDistanceToTrader)
+	[NonSerialized()]
+	protected autoptr map<string, bool> m_LargeVehicleClassNames;
 	[NonSerialized()]
 	private bool m_IsLoaded;
 	
@@ -125,6 +133,9 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 		m_Categories = new map<int, ref ExpansionMarketCategory>;
 		m_TraderZones = new array<ref ExpansionMarketTraderZone>;	
 		m_Traders = new array<ref ExpansionMarketTrader>;
+		m_CategoriesByFileName = new map<string, ExpansionMarketCategory>;
+		m_TradersByFileName = new map<string, ExpansionMarketTrader>;
+		m_LargeVehicleClassNames = new map<string, bool>;
 
 		Currencies = new TStringArray;
 		VehicleKeys = new TStringArray;
@@ -137,13 +148,29 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 	}
 
 	// ------------------------------------------------------------
-	protected void LoadCategories()
+	protected void LoadCategories(ExpansionMarketCatalogSnapshot snapshot)
 	{
 		//TraderPrint("LoadCategories - Start");
 		
 		if (!MarketSystemEnabled && !ATMSystemEnabled)
 			return;
 
+		ExpansionMarketCategory category;
+
+		if (snapshot.IsLoaded())
+		{
+			for (int i = 0; i < snapshot.GetCategoriesCount(); i++)
+			{
+				category = snapshot.ReadCategory();
+				TraderPrint("LoadCategories - Adding category ID " + category.CategoryID + " (" + category.m_FileName + ") from snapshot");
+				AddCategory(category);
+
+				NetworkCategories.Insert(new ExpansionMarketNetworkCategory(category));
+			}
+
+			return;
+		}
+
 		array< string > files = ExpansionStatic.FindFilesInLocation(EXPANSION_MARKET_FOLDER, ".json", true);
 
 		if (!files.Count())
@@ -152,6 +179,7 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 			
 			ExpansionStatic.MakeDirectoryRecursive(EXPANSION_MARKET_FOLDER);
 			DefaultCategories();
+			snapshot.Discard();
 			return;
 		}
 
@@ -160,12 +188,12 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 			//! Strip '.json' extension
 			fileName = fileName.Substring(0, fileName.Length() - 5);
 
-			auto category = ExpansionMarketCategory.Load(fileName);
+			category = ExpansionMarketCategory.Load(fileName, snapshot);
 			if (!category)
 				continue;
 
 			TraderPrint("LoadCategories - Adding category ID " + category.CategoryID + " (" + category.m_FileName + ")");
-			m_Categories.Insert(category.CategoryID, category);
+			AddCategory(category);
 
 			NetworkCategories.Insert(new ExpansionMarketNetworkCategory(category));
 		}
@@ -181,6 +209,8 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 		if (!MarketSystemEnabled)
 			return;
 
+		ExpansionMarketTraderZone zone;
+
 		//! Move existing files over from old location in $profile to new location in $mission
 		string folderNameOld = EXPANSION_FOLDER + "TraderZones\\";
 		if (FileExist(folderNameOld))
@@ -202,7 +232,7 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 			//! Strip '.json' extension
 			fileName = fileName.Substring(0, fileName.Length() - 5);
 
-			auto zone = ExpansionMarketTraderZone.Load(fileName);
+			zone = ExpansionMarketTraderZone.Load(fileName);
 			if (!zone)
 				continue;
 
@@ -214,13 +244,26 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 	}
 
 	// ------------------------------------------------------------
-	protected void LoadTraders()
+	protected void LoadTraders(ExpansionMarketCatalogSnapshot snapshot)
 	{
 		//TraderPrint("LoadTraders - Start");
 		
 		if (!MarketSystemEnabled)
 			return;
 
+		ExpansionMarketTrader trader;
+
+		if (snapshot.IsLoaded())
+		{
+			for (int i = 0; i < snapshot.GetTradersCount(); i++)
+			{
+				trader = snapshot.ReadTrader();
+				InsertMarketTrader(trader);
+			}
+
+			return;
+		}
+
 		array< string > files = ExpansionStatic.FindFilesInLocation(EXPANSION_TRADER_FOLDER, ".json", true);
 
 		if (!files.Count())
@@ -230,6 +273,7 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 			ExpansionStatic.MakeDirectoryRecursive(EXPANSION_TRADER_FOLDER);
 
 			DefaultTraders();
+			snapshot.Discard();
 
 			return;
 		}
@@ -239,11 +283,11 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 			//! Strip '.json' extension
 			fileName = fileName.Substring(0, fileName.Length() - 5);
 
-			auto trader = ExpansionMarketTrader.Load(fileName);
+			trader = ExpansionMarketTrader.Load(fileName, snapshot);
 			if (!trader)
 				continue;
 
-			m_Traders.Insert(trader);
+			InsertMarketTrader(trader);
 		}
 		
 		//TraderPrint("LoadTraders - End");
@@ -374,6 +418,7 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 		MaxLargeVehicleDistanceToTrader = s.MaxLargeVehicleDistanceToTrader;
 		
 		LargeVehicles.Copy(s.LargeVehicles);
+		UpdateLargeVehicleClassNames();
 		
 		Currencies.Copy(s.Currencies);
 		VehicleKeys.Copy(s.VehicleKeys);
@@ -418,7 +463,7 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 			{
 				ExpansionMarketCategory category = new ExpansionMarketCategory;
 				category.Copy(s.NetworkCategories[i]);
-				m_Categories.Insert(category.CategoryID, category);
+				AddCategory(category);
 			}
 		}
 		
@@ -458,8 +503,7 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 	{
 		//TraderPrint("UpdateMarketItem_Client - Start - " + networkItem.ClassName + " (" + networkItem.Stock + ") catID " + networkItem.CategoryID);
 
-		string clsName = networkItem.ClassName;
-		clsName.ToLower();
+		string clsName = ExpansionMarketClassName.Normalize(networkItem.ClassName);
 
 		ExpansionMarketCategory category = GetCategory(networkItem.CategoryID);
 
@@ -495,7 +539,7 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 		category.Defaults();
 		category.Save();
 		category.Finalize();
-		GetCategories().Set(category.CategoryID, category);
+		AddCategory(category);
 		NetworkCategories.Insert(new ExpansionMarketNetworkCategory(category));
 	}
 
@@ -699,6 +743,7 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 			trader.Defaults();
 			trader.Save();
 			trader.Finalize();
+			m_TradersByFileName.Set(GetIndexKey(trader.m_FileName), trader);
 		}
 		
 		//TraderPrint("DefaultTraders - End");
@@ -1114,10 +1159,44 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 			Defaults();
 		}
 
-		LoadCategories();
-		LoadTraders();
+		int start = TickCount(0);
+
+		//! Categories and traders are loaded from the catalog snapshot if none of their JSON files changed since it was written
+		ExpansionMarketCatalogSnapshot snapshot = new ExpansionMarketCatalogSnapshot(MarketSystemEnabled, ATMSystemEnabled);
+		bool fromSnapshot = snapshot.Load();
+
+		LoadCategories(snapshot);
+		LoadTraders(snapshot);
+
+		if (fromSnapshot)
+		{
+			EXPrint("[ExpansionMarketSettings] Loaded " + snapshot.ToDebugString() + " from " + EXPANSION_MARKET_CATALOG_SNAPSHOT + " in " + (TickCount(start) / 10000.0) + " ms");
+		}
+		else
+		{
+			EXPrint("[ExpansionMarketSettings] Loaded " + m_Categories.Count() + " categories, " + m_Traders.Count() + " traders from JSON in " + (TickCount(start) / 10000.0) + " ms");
+
+			snapshot.Save();
+		}
+
+		//! Trader zone files are saved with changed stock after trades, always load them from JSON
 		LoadTraderZones();
 
+		ExpansionMarketMigrationManifest.Get().Save();
+
+		UpdateLargeVehicleClassNames();
+
+		if (MarketSystemEnabled)
+		{
+			start = TickCount(0);
+
+			ExpansionMarketValidator validator = new ExpansionMarketValidator;
+			validator.Validate(m_Categories, m_Traders);
+			validator.Save();
+
+			EXPrint("[ExpansionMarketSettings] Validated market in " + (TickCount(start) / 10000.0) + " ms - " + validator.ToDebugString() + ", see " + EXPANSION_MARKET_VALIDATION_REPORT);
+		}
+
 		if (!marketSettingsExist)
 		{
 			Save();
@@ -1181,13 +1260,30 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 	//! Server only
 	ExpansionMarketCategory GetCategory(string fileName)
 	{
-		foreach (int categoryID, ExpansionMarketCategory currentCategory : m_Categories)
-		{
-			if (CF_String.EqualsIgnoreCase(currentCategory.m_FileName, fileName))
-				return currentCategory;
-		}
+		return m_CategoriesByFileName[GetIndexKey(fileName)];
+	}
+
+	protected void AddCategory(ExpansionMarketCategory category)
+	{
+		m_Categories.Set(category.CategoryID, category);
+
+		if (category.m_FileName != "")
+			m_CategoriesByFileName.Set(GetIndexKey(category.m_FileName), category);
+	}
+
+	protected void RemoveCategory(ExpansionMarketCategory category)
+	{
+		m_Categories.Remove(category.CategoryID);
 
-		return NULL;
+		if (category.m_FileName != "")
+			m_CategoriesByFileName.Remove(GetIndexKey(category.m_FileName));
+	}
+
+	//! Category and trader file names are looked up case-insensitively
+	protected static string GetIndexKey(string fileName)
+	{
+		fileName.ToLower();
+		return fileName;
 	}
 
 	// ------------------------------------------------------------
@@ -1218,55 +1314,235 @@ class ExpansionMarketSettings: ExpansionMarketSettingsBase
 
 	float GetMinVehicleDistanceToTrader(string className)
 	{
-		className.ToLower();
-		if (MaxVehicleDistanceToTrader < MaxLargeVehicleDistanceToTrader)
-		{
-			foreach (string largeVehicle : LargeVehicles)
-			{
-				if (className == largeVehicle)
-					return MaxVehicleDistanceToTrader;  //! Use normal vehicle max distance as large vehicle min distance
-			}
-		}
+		className = ExpansionMarketClassName.Normalize(className);
+		if (MaxVehicleDistanceToTrader < MaxLargeVehicleDistanceToTrader && m_LargeVehicleClassNames.Contains(className))
+			return MaxVehicleDistanceToTrader;  //! Use normal vehicle max distance as large vehicle min distance
 		return 0;
 	}
 
 	float GetMaxVehicleDistanceToTrader(string className)
 	{
-		className.ToLower();
+		className = ExpansionMarketClassName.Normalize(className);
+		if (m_LargeVehicleClassNames.Contains(className))
+			return MaxLargeVehicleDistanceToTrader;
+		return MaxVehicleDistanceToTrader;
+	}
+
+	protected void UpdateLargeVehicleClassNames()
+	{
+		m_LargeVehicleClassNames.Clear();
+
 		foreach (string largeVehicle : LargeVehicles)
 		{
-			if (className == largeVehicle)
-				return MaxLargeVehicleDistanceToTrader;
+			largeVehicle.ToLower();
+			m_LargeVehicleClassNames.Set(largeVehicle, true);
 		}
-		return MaxVehicleDistanceToTrader;
 	}
 
 	// ------------------------------------------------------------
 	ExpansionMarketTrader GetMarketTrader(string fileName)
 	{
-		foreach (ExpansionMarketTrader currentTrader : m_Traders)
-		{
-			if (CF_String.EqualsIgnoreCase(currentTrader.m_FileName, fileName))
-			{
-				return currentTrader;
-			}
-		}
-		return NULL;
+		return m_TradersByFileName[GetIndexKey(fileName)];
 	}
 	
 	void AddMarketTrader(ExpansionMarketTrader trader)
 	{
 		EXPrint("Caching trader " + trader.m_FileName);
+		InsertMarketTrader(trader);
+	}
+
+	protected void InsertMarketTrader(ExpansionMarketTrader trader)
+	{
 		m_Traders.Insert(trader);
+		m_TradersByFileName.Set(GetIndexKey(trader.m_FileName), trader);
 	}
 
 	void ClearMarketCaches()
 	{
 		EXPrint("Clearing cached categories " + m_Categories.Count());
 		m_Categories.Clear();
+		m_CategoriesByFileName.Clear();
 		ExpansionMarketCategory.ClearGlobalItems();
 		EXPrint("Clearing cached traders " + m_Traders.Count());
 		m_Traders.Clear();
+		m_TradersByFileName.Clear();
+	}
+	
+	//! Server. Applies changed, added and removed category and trader files (names without extension) in place,
+	//! keeping IDs of unchanged items (see ExpansionMarketCatalogWatcher)
+	ExpansionMarketCatalogChanges ReloadFiles(TStringArray categoryFiles, TStringArray removedCategoryFiles, TStringArray traderFiles, TStringArray removedTraderFiles)
+	{
+		ExpansionMarketCatalogChanges changes = new ExpansionMarketCatalogChanges;
+		map<int, ref ExpansionMarketCategory> changedCategories = new map<int, ref ExpansionMarketCategory>;
+
+		foreach (string removedCategoryFile : removedCategoryFiles)
+		{
+			ExpansionMarketCategory removedCategory = GetCategory(removedCategoryFile);
+			if (!removedCategory)
+				continue;
+
+			int removedCategoryID = removedCategory.CategoryID;
+
+			TraderPrint("ReloadFiles - Removing category ID " + removedCategoryID + " (" + removedCategoryFile + ")");
+
+			changes.m_ItemsRemoved += removedCategory.Items.Count();
+			removedCategory.Unload();
+			RemoveCategory(removedCategory);
+			SetNetworkCategory(removedCategoryID, null);
+			changes.m_RemovedCategoryIDs.Insert(removedCategoryID);
+		}
+
+		foreach (string categoryFile : categoryFiles)
+		{
+			ExpansionMarketCategory category = GetCategory(categoryFile);
+			if (category)
+			{
+				ExpansionMarketCategory source = ExpansionMarketCategory.Parse(categoryFile);
+				if (!source)
+					continue;
+
+				int added;
+				int removed;
+				int modified;
+				category.Reload(source, added, removed, modified);
+
+				TraderPrint("ReloadFiles - Reloaded category ID " + category.CategoryID + " (" + categoryFile + "), items: " + added + " added, " + removed + " removed, " + modified + " modified");
+
+				changes.m_ItemsAdded += added;
+				changes.m_ItemsRemoved += removed;
+				changes.m_ItemsModified += modified;
+			}
+			else
+			{
+				category = ExpansionMarketCategory.Load(categoryFile);
+				if (!category)
+					continue;
+
+				TraderPrint("ReloadFiles - Adding category ID " + category.CategoryID + " (" + categoryFile + ")");
+
+				AddCategory(category);
+				changes.m_ItemsAdded += category.Items.Count();
+			}
+
+			SetNetworkCategory(category.CategoryID, category);
+			changedCategories.Insert(category.CategoryID, category);
+			changes.m_Categories.Insert(new ExpansionMarketNetworkCategory(category));
+		}
+
+		foreach (string removedTraderFile : removedTraderFiles)
+		{
+			ExpansionMarketTrader removedTrader = GetMarketTrader(removedTraderFile);
+			if (!removedTrader)
+				continue;
+
+			//! Trader objects keep their reference to the trader until restart
+			TraderPrint("ReloadFiles - Removing trader " + removedTraderFile);
+			m_Traders.RemoveItem(removedTrader);
+			m_TradersByFileName.Remove(GetIndexKey(removedTrader.m_FileName));
+		}
+
+		//! Trader item lists may name items of any category, so all traders are loaded again when categories changed
+		TStringArray reloadTraderFiles = new TStringArray;
+		if (changedCategories.Count() || changes.m_RemovedCategoryIDs.Count())
+		{
+			foreach (ExpansionMarketTrader currentTrader : m_Traders)
+			{
+				reloadTraderFiles.Insert(currentTrader.m_FileName);
+			}
+		}
+
+		foreach (string traderFile : traderFiles)
+		{
+			if (reloadTraderFiles.Find(traderFile) == -1)
+				reloadTraderFiles.Insert(traderFile);
+		}
+
+		foreach (string reloadTraderFile : reloadTraderFiles)
+		{
+			ExpansionMarketTrader trader = ExpansionMarketTrader.Load(reloadTraderFile);
+			if (!trader)
+				continue;
+
+			ExpansionMarketTrader existingTrader = GetMarketTrader(reloadTraderFile);
+			if (existingTrader)
+				existingTrader.Reload(trader);
+			else
+				InsertMarketTrader(trader);
+
+			changes.m_Traders.Insert(reloadTraderFile);
+		}
+
+		//! Drop stock of removed items, add stock for new items
+		if (changedCategories.Count() || changes.m_RemovedCategoryIDs.Count())
+		{
+			ExpansionMarketStockDefaults stockDefaults = new ExpansionMarketStockDefaults(changedCategories);
+
+			foreach (ExpansionMarketTraderZone zone : m_TraderZones)
+			{
+				zone.Update(true, stockDefaults);
+			}
+		}
+
+		ExpansionMarketMigrationManifest.Get().Save();
+
+		return changes;
+	}
+
+	//! Client. Drops cached items of changed categories and traders, they are requested again when a trader menu is opened
+	void ApplyCatalogChanges(ExpansionMarketCatalogChanges changes)
+	{
+		foreach (int removedCategoryID : changes.m_RemovedCategoryIDs)
+		{
+			ExpansionMarketCategory removedCategory = m_Categories[removedCategoryID];
+			if (!removedCategory)
+				continue;
+
+			removedCategory.Unload();
+			RemoveCategory(removedCategory);
+		}
+
+		foreach (ExpansionMarketNetworkCategory networkCategory : changes.m_Categories)
+		{
+			ExpansionMarketCategory category = m_Categories[networkCategory.CategoryID];
+			if (category)
+			{
+				category.Unload();
+			}
+			else
+			{
+				category = new ExpansionMarketCategory;
+			}
+
+			category.Copy(networkCategory);
+			AddCategory(category);
+		}
+
+		foreach (string traderFile : changes.m_Traders)
+		{
+			ExpansionMarketTrader trader = GetMarketTrader(traderFile);
+			if (trader)
+				trader.ClearItems();
+		}
+	}
+
+	//! Replaces (or removes if `category` is null) the network category with ID `categoryID`, adds it if not present
+	protected void SetNetworkCategory(int categoryID, ExpansionMarketCategory category)
+	{
+		foreach (int i, ExpansionMarketNetworkCategory networkCategory : NetworkCategories)
+		{
+			if (networkCategory.CategoryID != categoryID)
+				continue;
+
+			if (category)
+				NetworkCategories.Set(i, new ExpansionMarketNetworkCategory(category));
+			else
+				NetworkCategories.RemoveOrdered(i);
+
+			return;
+		}
+
+		if (category)
+			NetworkCategories.Insert(new ExpansionMarketNetworkCategory(category));
 	}
 	
 	void AddMarketZone(ExpansionMarketTraderZone zone)
@@ -71,8 +71,20 @@ class ExpansionMarketTrader : ExpansionMarketTraderBase
 	[NonSerialized()]
 	bool m_StockOnly;
 
+	//! Server only! Item classnames that do not exist in the market (see ExpansionMarketValidator)
+	[NonSerialized()]
+	ref TStringArray m_MissingItems = new TStringArray;
+
+	//! Server only! Items added before Finalize are appended unordered and sorted by ID once in Finalize
+	[NonSerialized()]
+	protected bool m_IsFinalized;
+
 	[NonSerialized()]
 	int m_DisplayCurrencyPrecision;
+
+	//! Server only! Hash of the items as sent to clients, excluding stock (see ExpansionMarketTraderZone::GetCatalogHash)
+	[NonSerialized()]
+	int m_CatalogHash;
 	
 	// ------------------------------------------------------------
 	// ExpansionMarketTrader Constructor
@@ -91,105 +103,154 @@ class ExpansionMarketTrader : ExpansionMarketTraderBase
 	// ------------------------------------------------------------
 	// Expansion ExpansionMarketTrader Load
 	// ------------------------------------------------------------	
-	static ExpansionMarketTrader Load(string name)
+	static ExpansionMarketTrader Load(string name, ExpansionMarketCatalogSnapshot snapshot = null)
 	{
-		ExpansionMarketTrader settingsDefault = new ExpansionMarketTrader;
-		settingsDefault.Defaults();
-		
+		string path = EXPANSION_TRADER_FOLDER + name + ".json";
+
+		ExpansionMarketMigrationManifest manifest = ExpansionMarketMigrationManifest.Get();
+
 		ExpansionMarketTrader settings = new ExpansionMarketTrader;
-		
-		ExpansionMarketTraderBase settingsBase;
-		
-		if (!ExpansionJsonFileParser<ExpansionMarketTraderBase>.Load( EXPANSION_TRADER_FOLDER + name + ".json", settingsBase ))
-			return NULL;
-		
-		//! Automatically convert outdated trader files to current version
-		if (settingsBase.m_Version < VERSION)
+		int version = VERSION;
+
+		//! Files already loaded at current version are parsed once, others are probed for their version first
+		if (!manifest.IsCurrent(path, VERSION) || !ExpansionJsonFileParser<ExpansionMarketTrader>.Load( path, settings ) || settings.m_Version < VERSION)
 		{
-			settings.DisplayName = settingsBase.DisplayName;
+			ExpansionMarketTraderBase settingsBase;
+			if (!ExpansionJsonFileParser<ExpansionMarketTraderBase>.Load( path, settingsBase ))
+				return NULL;
 
-			EXPrint("ExpansionMarketTrader::Load - Converting v" + settingsBase.m_Version + " \"" + EXPANSION_TRADER_FOLDER + name + "\" to v" + VERSION);
+			version = settingsBase.m_Version;
+			settings = new ExpansionMarketTrader;
 
-			if (settingsBase.m_Version == 3)
+			//! Automatically convert outdated trader files to current version
+			if (version < VERSION)
 			{
-				ExpansionMarketTraderV3 settings_v3;
-		
-				if (!ExpansionJsonFileParser<ExpansionMarketTraderV3>.Load( EXPANSION_TRADER_FOLDER + name + ".json", settings_v3 ))
-					return NULL;
+				settings.DisplayName = settingsBase.DisplayName;
+				settings.m_FileName = name;
 
-				foreach (string item : settings_v3.Items)
-				{
-					item.ToLower();
-					settings.AddItem(item);
-				}
-			}
-			else if (settingsBase.m_Version >= 4)
-			{
-				if (!ExpansionJsonFileParser<ExpansionMarketTrader>.Load( EXPANSION_TRADER_FOLDER + name + ".json", settings ))
-					return NULL;
-			}
+				EXPrint("ExpansionMarketTrader::Load - Converting v" + version + " \"" + path + "\" to v" + VERSION);
 
-			if (settingsBase.m_Version < 5)
-				settings.DefaultCurrencies();
+				if (version == 3)
+				{
+					ExpansionMarketTraderV3 settings_v3;
+			
+					if (!ExpansionJsonFileParser<ExpansionMarketTraderV3>.Load( path, settings_v3 ))
+						return NULL;
 
-			if (settingsBase.m_Version < 6)
-				settings.TraderIcon = settingsDefault.TraderIcon;
+					foreach (string item : settings_v3.Items)
+					{
+						settings.AddItem(item);
+					}
+				}
+				else if (version >= 4)
+				{
+					if (!ExpansionJsonFileParser<ExpansionMarketTrader>.Load( path, settings ))
+						return NULL;
+				}
 
-			if (settingsBase.m_Version < 10)
-			{
-				ExpansionMarketTraderV9 settings_v9;
-				if (!ExpansionJsonFileParser<ExpansionMarketTraderV9>.Load( EXPANSION_TRADER_FOLDER + name + ".json", settings_v9 ))
+				if (!GetMigrations().Run(settings, path, version))
 					return NULL;
+
+				settings.m_Version = VERSION;
 				
-				settings.MinRequiredReputation = settings_v9.MinRequiredHumanity;
-				settings.MaxRequiredReputation = settings_v9.MaxRequiredHumanity;
+				ExpansionMarketMigrationWriter<ExpansionMarketTrader>.Save(path, settings);
 			}
-
-			if (settingsBase.m_Version < 11)
-			{	
-				settings.RequiredFaction = settingsDefault.RequiredFaction;
-
-				settings.RequiredCompletedQuestID = settingsDefault.RequiredCompletedQuestID;
+			else
+			{
+				if (!ExpansionJsonFileParser<ExpansionMarketTrader>.Load( path, settings ))
+					return NULL;
 			}
-			
-			if (settingsBase.m_Version < 12 && !settings.DisplayCurrencyValue)
-				settings.DisplayCurrencyValue = settingsDefault.DisplayCurrencyValue;
 
-			settings.m_Version = VERSION;
-			settings.m_FileName = name;
-			
-			settings.Save();
+			manifest.SetVersion(path, VERSION);
 		}
-		else
+
+		settings.m_FileName = name;
+		
+		if (snapshot)
 		{
-			if (!ExpansionJsonFileParser<ExpansionMarketTrader>.Load( EXPANSION_TRADER_FOLDER + name + ".json", settings ))
-				return NULL;
-			settings.m_FileName = name;
+			//! V3 items were already added above, not reproducible from recorded item map
+			if (version >= 4)
+				snapshot.WriteTrader(settings);
+			else
+				snapshot.Discard();
 		}
+
+		settings.OnLoaded(version >= 4);
 		
-		if (settingsBase.m_Version >= 5)
+		return settings;
+	}
+
+	protected static ref ExpansionMarketMigrationPipeline s_Migrations;
+
+	static ExpansionMarketMigrationPipeline GetMigrations()
+	{
+		if (!s_Migrations)
 		{
-			//! Make sure currencies are lowercase
-			settings.Currencies = ExpansionMarketSettings.StringArrayToLower(settings.Currencies);
+			s_Migrations = new ExpansionMarketMigrationPipeline;
+			s_Migrations.Register(5, new ExpansionMarketTraderMigrationV5);
+			s_Migrations.Register(6, new ExpansionMarketTraderMigrationV6);
+			s_Migrations.Register(10, new ExpansionMarketTraderMigrationV10);
+			s_Migrations.Register(11, new ExpansionMarketTraderMigrationV11);
+			s_Migrations.Register(12, new ExpansionMarketTraderMigrationV12);
 		}
-			
-		if (settingsBase.m_Version >= 4)
+
+		return s_Migrations;
+	}
+
+	//! Adds items and finalizes the trader. Called after loading from JSON or catalog snapshot (see ExpansionMarketCatalogSnapshot)
+	//! @param addItems  whether Items as loaded still need to be added (false if already added while converting from v3)
+	void OnLoaded(bool addItems = true)
+	{
+		if (addItems)
 		{
-			//! Make sure item classnames are lowercase
-			map<string, ExpansionMarketTraderBuySell> items = settings.Items;
-			settings.Items = new map<string, ExpansionMarketTraderBuySell>;
+			//! Make sure currencies are lowercase (currencies were added with v5, older files get lowercase defaults)
+			Currencies = ExpansionMarketSettings.StringArrayToLower(Currencies);
+
+			//! Make sure item classnames are lowercase (see AddItem)
+			map<string, ExpansionMarketTraderBuySell> items = Items;
+			Items = new map<string, ExpansionMarketTraderBuySell>;
 			foreach (string className, ExpansionMarketTraderBuySell buySell : items)
 			{
-				className.ToLower();
-				settings.AddItem(className, buySell);
+				AddItem(className, buySell);
 			}
 		}
 
-		settings.m_DisplayCurrencyPrecision = ExpansionStatic.GetPrecision(settings.DisplayCurrencyValue);
+		m_DisplayCurrencyPrecision = ExpansionStatic.GetPrecision(DisplayCurrencyValue);
 		
-		settings.Finalize();
-		
-		return settings;
+		Finalize();
+	}
+
+	//! Server. Takes over settings and finalized items of `trader` (loaded again from changed files) in place,
+	//! so trader objects referencing this trader stay valid
+	void Reload(ExpansionMarketTrader trader)
+	{
+		m_Version = trader.m_Version;
+		DisplayName = trader.DisplayName;
+		MinRequiredReputation = trader.MinRequiredReputation;
+		MaxRequiredReputation = trader.MaxRequiredReputation;
+		RequiredFaction = trader.RequiredFaction;
+		RequiredCompletedQuestID = trader.RequiredCompletedQuestID;
+		TraderIcon = trader.TraderIcon;
+		Currencies.Copy(trader.Currencies);
+		DisplayCurrencyValue = trader.DisplayCurrencyValue;
+		DisplayCurrencyName = trader.DisplayCurrencyName;
+		m_DisplayCurrencyPrecision = trader.m_DisplayCurrencyPrecision;
+		Categories.Copy(trader.Categories);
+
+		Items = trader.Items;
+		m_Categories = trader.m_Categories;
+		m_Items = trader.m_Items;
+		m_IsFinalized = trader.m_IsFinalized;
+		m_MissingItems = trader.m_MissingItems;
+		m_CatalogHash = 0;
+	}
+
+	//! Client. Drops synched items so they are requested again in full the next time the trader menu is opened
+	void ClearItems()
+	{
+		Items.Clear();
+		m_Items.Clear();
+		m_StockOnly = false;
 	}
 
 	// ------------------------------------------------------------
@@ -232,7 +293,7 @@ class ExpansionMarketTrader : ExpansionMarketTraderBase
 	// ------------------------------------------------------------
 	ExpansionMarketTraderItem AddItem( string item, ExpansionMarketTraderBuySell buySell = ExpansionMarketTraderBuySell.CanBuyAndSell )
 	{
-		item.ToLower();
+		item = ExpansionMarketClassName.Normalize(item);
 		if (Items.Contains(item))
 			return NULL;  //! Already added, possibly implicitly by adding a variant before the parent (which will add the parent first)
 
@@ -246,6 +307,9 @@ class ExpansionMarketTrader : ExpansionMarketTraderBase
 
 		CF_Log.Warn( "[ExpansionMarketTrader] Error: The \"" + item + "\" does not exist in the market!" );
 
+		if (m_MissingItems.Find(item) == -1)
+			m_MissingItems.Insert(item);
+
 		return NULL;
 	}
 
@@ -263,10 +327,11 @@ class ExpansionMarketTrader : ExpansionMarketTraderBase
 	{
 		Items.Insert( item.MarketItem.ClassName, item.BuySell );
 
-		//! Inserting ordered by ID ensures same order of IDs as given to items by categories (only required on server for correct netsynch)
+		//! Inserting ordered by ID ensures same order of IDs as given to items by categories (only required on server for correct netsynch).
+		//! While loading, items are only sorted once in Finalize.
 		int count = m_Items.Count();
 		int i;
-		if (!count || GetGame().IsClient() || item.MarketItem.ItemID >= m_Items[count - 1].MarketItem.ItemID)
+		if (!count || !m_IsFinalized || GetGame().IsClient() || item.MarketItem.ItemID >= m_Items[count - 1].MarketItem.ItemID)
 		{
 			m_Items.Insert( item );
 		}
@@ -293,6 +358,11 @@ class ExpansionMarketTrader : ExpansionMarketTraderBase
 	//! Adds any missing items, variants and attachments
 	void Finalize()
 	{
+		#ifdef EXPANSIONMODMARKET_DEBUG
+		int start = TickCount(0);
+		int count = m_Items.Count();
+		#endif
+
 		//! Add any missing items from categories
 		ExpansionMarketCategory cat;
 		if (GetGame().IsServer())
@@ -301,12 +371,11 @@ class ExpansionMarketTrader : ExpansionMarketTraderBase
 			{
 				ExpansionMarketTraderBuySell catBuySell = ExpansionMarketTraderBuySell.CanBuyAndSell;
 
-				TStringArray parts = new TStringArray;
-				fileName.Split(":", parts);
-				if (parts.Count() == 2)
+				int separator = fileName.IndexOf(":");
+				if (separator > -1)
 				{
-					fileName = parts[0];
-					catBuySell = parts[1].ToInt();
+					catBuySell = fileName.Substring(separator + 1, fileName.Length() - separator - 1).ToInt();
+					fileName = fileName.Substring(0, separator);
 				}
 
 				cat = GetExpansionSettings().GetMarket().GetCategory(fileName);
@@ -340,6 +409,39 @@ class ExpansionMarketTrader : ExpansionMarketTraderBase
 
 		//! Add any missing variants and attachments
 		AddAttachmentsAndVariants(m_Items);
+
+		if (GetGame().IsServer() && !m_IsFinalized)
+		{
+			SortItems();
+			m_IsFinalized = true;
+		}
+
+		#ifdef EXPANSIONMODMARKET_DEBUG
+		EXPrint("ExpansionMarketTrader::Finalize - " + m_FileName + " - " + count + " items added directly, " + m_Items.Count() + " items total (" + m_Categories.Count() + " categories) in " + (TickCount(start) / 10000.0) + " ms");
+		#endif
+	}
+
+	//! Orders items by ID (IDs are unique per trader since Items is keyed by class name)
+	protected void SortItems()
+	{
+		map<int, ExpansionMarketTraderItem> itemsByID = new map<int, ExpansionMarketTraderItem>;
+		TIntArray ids = new TIntArray;
+
+		foreach (ExpansionMarketTraderItem item : m_Items)
+		{
+			itemsByID.Insert(item.MarketItem.ItemID, item);
+			ids.Insert(item.MarketItem.ItemID);
+		}
+
+		ids.Sort();
+
+		array<ref ExpansionMarketTraderItem> items = new array<ref ExpansionMarketTraderItem>;
+		foreach (int id : ids)
+		{
+			items.Insert(itemsByID[id]);
+		}
+
+		m_Items = items;
 	}
 
 	protected void AddCategoryItems(ExpansionMarketCategory cat, ExpansionMarketTraderBuySell buySell)
@@ -355,35 +457,41 @@ class ExpansionMarketTrader : ExpansionMarketTraderBase
 
 	void AddAttachmentsAndVariants(array<ref ExpansionMarketTraderItem> items)
 	{
-		map<string, ExpansionMarketTraderBuySell> toAdd = new map<string, ExpansionMarketTraderBuySell>;
+		//! Attachments and variants can themselves have attachments and variants, so added items are appended to the worklist.
+		//! Items doubles as visited set, each class name is only added once.
+		array<ExpansionMarketTraderItem> worklist = new array<ExpansionMarketTraderItem>;
+		foreach (ExpansionMarketTraderItem sourceItem : items)
+		{
+			worklist.Insert(sourceItem);
+		}
 
-		foreach (ExpansionMarketTraderItem item : items)
+		ExpansionMarketTraderItem item;
+		ExpansionMarketTraderItem addedItem;
+		int next;
+		while (next < worklist.Count())
 		{
+			item = worklist[next++];
+
 			foreach ( string attachment : item.MarketItem.SpawnAttachments )
 			{
-				if ( !Items.Contains( attachment ) && !toAdd.Contains( attachment ) )
-					toAdd.Insert( attachment, ExpansionMarketTraderBuySell.CanBuyAndSellAsAttachmentOnly );
+				if ( Items.Contains( attachment ) )
+					continue;
+
+				addedItem = AddItem( attachment, ExpansionMarketTraderBuySell.CanBuyAndSellAsAttachmentOnly );
+				if (addedItem)
+					worklist.Insert(addedItem);
 			}
 
 			foreach ( string variant : item.MarketItem.Variants )
 			{
-				if ( !Items.Contains( variant ) && !toAdd.Contains( variant ) )
-					toAdd.Insert( variant, item.BuySell );
-			}
-		}
-
-		array<ref ExpansionMarketTraderItem> addedItems = new array<ref ExpansionMarketTraderItem>;
+				if ( Items.Contains( variant ) )
+					continue;
 
-		foreach (string className, ExpansionMarketTraderBuySell buySell : toAdd)
-		{
-			ExpansionMarketTraderItem addedItem = AddItem( className, buySell );
-			if (addedItem)
-				addedItems.Insert(addedItem);
+				addedItem = AddItem( variant, item.BuySell );
+				if (addedItem)
+					worklist.Insert(addedItem);
+			}
 		}
-
-		//! We need to do this recursively, since attachments and variants can themselves have attachments and variants...
-		if (addedItems.Count())
-			AddAttachmentsAndVariants(addedItems);
 	}
 
 	// ------------------------------------------------------------
@@ -391,28 +499,28 @@ class ExpansionMarketTrader : ExpansionMarketTraderBase
 	// ------------------------------------------------------------
 	bool ItemExists( string item )
 	{
-		item.ToLower();
+		item = ExpansionMarketClassName.Normalize(item);
 		return Items.Contains( item );
 	}
 	
 	//! Whether the player can sell this item to this specific trader
 	bool CanSellItem( string item )
 	{
-		item.ToLower();
+		item = ExpansionMarketClassName.Normalize(item);
 		return Items.Get( item ) != ExpansionMarketTraderBuySell.CanOnlyBuy;
 	}
 	
 	//! Whether the player can buy this item at this specific trader
 	bool CanBuyItem( string item )
 	{
-		item.ToLower();
+		item = ExpansionMarketClassName.Normalize(item);
 		return Items.Get( item ) != ExpansionMarketTraderBuySell.CanOnlySell;
 	}
 	
 	//! Whether this item can only be bought & sold as attachment on another item
 	bool IsAttachmentBuySell( string item )
 	{
-		item.ToLower();
+		item = ExpansionMarketClassName.Normalize(item);
 		return Items.Get( item ) == ExpansionMarketTraderBuySell.CanBuyAndSellAsAttachmentOnly;
 	}
 }
@@ -428,3 +536,78 @@ class ExpansionMarketTraderItem
 		BuySell = buySell;
 	}
 }
+
+class ExpansionMarketTraderMigrationV5: ExpansionMarketMigrationStep
+{
+	override bool Apply(Class settings, string path, int fromVersion)
+	{
+		ExpansionMarketTrader.Cast(settings).DefaultCurrencies();
+
+		return true;
+	}
+}
+
+class ExpansionMarketTraderMigrationV6: ExpansionMarketMigrationStep
+{
+	override bool Apply(Class settings, string path, int fromVersion)
+	{
+		ExpansionMarketTrader settingsDefault = new ExpansionMarketTrader;
+		settingsDefault.Defaults();
+
+		ExpansionMarketTrader.Cast(settings).TraderIcon = settingsDefault.TraderIcon;
+
+		return true;
+	}
+}
+
+//! Humanity was renamed to reputation
+class ExpansionMarketTraderMigrationV10: ExpansionMarketMigrationStep
+{
+	override bool Apply(Class settings, string path, int fromVersion)
+	{
+		ExpansionMarketTrader trader = ExpansionMarketTrader.Cast(settings);
+
+		ExpansionMarketTraderV9 settings_v9;
+		if (!ExpansionJsonFileParser<ExpansionMarketTraderV9>.Load( path, settings_v9 ))
+			return false;
+		
+		trader.MinRequiredReputation = settings_v9.MinRequiredHumanity;
+		trader.MaxRequiredReputation = settings_v9.MaxRequiredHumanity;
+
+		return true;
+	}
+}
+
+class ExpansionMarketTraderMigrationV11: ExpansionMarketMigrationStep
+{
+	override bool Apply(Class settings, string path, int fromVersion)
+	{
+		ExpansionMarketTrader trader = ExpansionMarketTrader.Cast(settings);
+
+		ExpansionMarketTrader settingsDefault = new ExpansionMarketTrader;
+		settingsDefault.Defaults();
+
+		trader.RequiredFaction = settingsDefault.RequiredFaction;
+		trader.RequiredCompletedQuestID = settingsDefault.RequiredCompletedQuestID;
+
+		return true;
+	}
+}
+
+class ExpansionMarketTraderMigrationV12: ExpansionMarketMigrationStep
+{
+	override bool Apply(Class settings, string path, int fromVersion)
+	{
+		ExpansionMarketTrader trader = ExpansionMarketTrader.Cast(settings);
+
+		if (!trader.DisplayCurrencyValue)
+		{
+			ExpansionMarketTrader settingsDefault = new ExpansionMarketTrader;
+			settingsDefault.Defaults();
+
+			trader.DisplayCurrencyValue = settingsDefault.DisplayCurrencyValue;
+		}
+
+		return true;
+	}
+}
@@ -68,12 +68,11 @@ class ExpansionMarketTraderZone: ExpansionMarketTraderZoneBase
 	// ------------------------------------------------------------
 	static ExpansionMarketTraderZone Load(string name)
 	{
-		ExpansionMarketTraderZone settingsDefault = new ExpansionMarketTraderZone;
-		settingsDefault.Defaults();
+		string path = EXPANSION_TRADER_ZONES_FOLDER + name + ".json";
 
 		ExpansionMarketTraderZone settings = new ExpansionMarketTraderZone;
 		
-		if (!ExpansionJsonFileParser<ExpansionMarketTraderZone>.Load( EXPANSION_TRADER_ZONES_FOLDER + name + ".json", settings ))
+		if (!ExpansionJsonFileParser<ExpansionMarketTraderZone>.Load( path, settings ))
 			return NULL;
 
 		settings.m_FileName = name;
@@ -83,36 +82,39 @@ class ExpansionMarketTraderZone: ExpansionMarketTraderZoneBase
 		settings.Stock = new map<string, int>;
 		foreach (string className, int stock : items)
 		{
-			className.ToLower();
+			className = ExpansionMarketClassName.Normalize(className);
 			settings.Stock.Insert(className, stock);
 		}
 
 		//! Automatically convert outdated trader zone files to current version
 		if (settings.m_Version < VERSION)
 		{
-			if (settings.m_Version < 4)
-			{
-				settings.BuyPricePercent = settingsDefault.BuyPricePercent;
-			}
-			else if (settings.m_Version < 5)
-			{
-				ExpansionMarketTraderZoneV4 settingsV4;
-				if (!ExpansionJsonFileParser<ExpansionMarketTraderZoneV4>.Load( EXPANSION_TRADER_ZONES_FOLDER + name + ".json", settingsV4 ))
-					return NULL;
-
-				settings.BuyPricePercent = settingsV4.PricePercent;
-			}
-
-			settings.SellPricePercent = settingsDefault.SellPricePercent;
+			if (!GetMigrations().Run(settings, path, settings.m_Version))
+				return NULL;
 
 			settings.m_Version = VERSION;
 
-			settings.Save();
+			ExpansionMarketMigrationWriter<ExpansionMarketTraderZone>.Save(path, settings);
 		}
 
 		return settings;
 	}
 	
+	protected static ref ExpansionMarketMigrationPipeline s_Migrations;
+
+	static ExpansionMarketMigrationPipeline GetMigrations()
+	{
+		if (!s_Migrations)
+		{
+			s_Migrations = new ExpansionMarketMigrationPipeline;
+			s_Migrations.Register(4, new ExpansionMarketTraderZoneMigrationV4);
+			s_Migrations.Register(5, new ExpansionMarketTraderZoneMigrationV5);
+			s_Migrations.Register(6, new ExpansionMarketTraderZoneMigrationV6);
+		}
+
+		return s_Migrations;
+	}
+	
 	// ------------------------------------------------------------
 	// ExpansionMarketTraderZone Save
 	// ------------------------------------------------------------	
@@ -247,11 +249,10 @@ class ExpansionMarketTraderZone: ExpansionMarketTraderZoneBase
 		item.AttachmentIDs = new array< int >;
 		foreach (string className: tItem.MarketItem.SpawnAttachments)
 		{
+			//! Attachments that do not exist in the market are reported once on load (see ExpansionMarketValidator)
 			ExpansionMarketItem attachment = ExpansionMarketCategory.GetGlobalItem(className);
 			if (attachment)
 				item.AttachmentIDs.Insert(attachment.ItemID);
-			else
-				EXPrint("ExpansionMarketTraderZone::GetNetworkItemSerialization - WARNING: Attachment '" + className + "' does not exist!");
 		}
 		item.Variants = new array< string >;
 		item.Variants.Copy(tItem.MarketItem.Variants);
@@ -275,6 +276,29 @@ class ExpansionMarketTraderZone: ExpansionMarketTraderZoneBase
 		return item;
 	}
 
+	//! Hash of all items of `trader` as sent to clients, excluding stock. Clients keep a catalog cache per trader keyed by this hash
+	//! (see ExpansionMarketClientCatalogCache). Items do not depend on the zone apart from stock, so the hash is cached on the trader.
+	int GetCatalogHash( ExpansionMarketTrader trader )
+	{
+		if ( trader.m_CatalogHash )
+			return trader.m_CatalogHash;
+
+		int hash = trader.m_Items.Count();
+
+		foreach ( ExpansionMarketTraderItem tItem: trader.m_Items )
+		{
+			hash = GetNetworkItemSerialization( tItem, false ).GetCatalogHash( hash );
+		}
+
+		//! Zero means no hash (client won't cache)
+		if ( !hash )
+			hash = 1;
+
+		trader.m_CatalogHash = hash;
+
+		return hash;
+	}
+
 	// ------------------------------------------------------------
 	// ExpansionMarketTraderZone SetStock
 	// ------------------------------------------------------------
@@ -292,7 +316,7 @@ class ExpansionMarketTraderZone: ExpansionMarketTraderZoneBase
 		EXPrint("ExpansionMarketTraderZone::SetStock_Internal - Start - " + className + " " + stock + " add " + addToExisting);
 		#endif
 		
-		className.ToLower();
+		className = ExpansionMarketClassName.Normalize(className);
 
 		ExpansionMarketItem marketItem = ExpansionMarketCategory.GetGlobalItem( className, false );
 		if ( !marketItem )
@@ -341,7 +365,7 @@ class ExpansionMarketTraderZone: ExpansionMarketTraderZoneBase
 		EXPrint("ExpansionMarketTraderZone::ClearReservedStock - Start");
 		#endif
 
-		className.ToLower();
+		className = ExpansionMarketClassName.Normalize(className);
 
 		ExpansionMarketItem marketItem = ExpansionMarketCategory.GetGlobalItem( className );
 		if ( !marketItem )
@@ -385,7 +409,7 @@ class ExpansionMarketTraderZone: ExpansionMarketTraderZoneBase
 		auto trace = CF_Trace_0(ExpansionTracing.MARKET, this, "RemoveStock");
 #endif
 	
-		className.ToLower();
+		className = ExpansionMarketClassName.Normalize(className);
 
 		ExpansionMarketItem marketItem = ExpansionMarketCategory.GetGlobalItem( className );
 		if ( !marketItem )
@@ -426,7 +450,7 @@ class ExpansionMarketTraderZone: ExpansionMarketTraderZoneBase
 	// ------------------------------------------------------------
 	bool ItemExists(string className)
 	{
-		className.ToLower();
+		className = ExpansionMarketClassName.Normalize(className);
 		
 		return Stock.Contains(className);
 	}
@@ -441,7 +465,7 @@ class ExpansionMarketTraderZone: ExpansionMarketTraderZoneBase
 		auto trace = CF_Trace_0(ExpansionTracing.MARKET, this, "GetStock");
 #endif
 
-		className.ToLower();
+		className = ExpansionMarketClassName.Normalize(className);
 
 		if (!ItemExists(className))
 		{
@@ -474,7 +498,8 @@ class ExpansionMarketTraderZone: ExpansionMarketTraderZoneBase
 	}
 
 	//! Updates stock - optionally removes items that do no longer exist and/or adds items from categories
-	void Update(bool removeNonExistent = false, map<int, ref ExpansionMarketCategory> categories = NULL)
+	//! @param stockDefaults  Stock is added for items of these defaults that have no persisted stock in this zone yet
+	void Update(bool removeNonExistent = false, ExpansionMarketStockDefaults stockDefaults = NULL)
 	{
 		int removed;
 
@@ -499,28 +524,96 @@ class ExpansionMarketTraderZone: ExpansionMarketTraderZoneBase
 
 		int added;
 
-		if (categories)
+		if (stockDefaults)
 		{
-			foreach (ExpansionMarketCategory cat : categories)
+			foreach (int i, string defaultClassName : stockDefaults.m_ClassNames)
 			{
-				foreach (ExpansionMarketItem item: cat.Items)
-				{
-					if (!Stock.Contains(item.ClassName))
-					{
-						EXPrint("ExpansionMarketTraderZone::Update - " + m_FileName + " - adding " + item.ClassName);
-						int newStock;
-						if (item.IsStaticStock())
-							newStock = 1;
-						else
-							newStock = item.MaxStockThreshold;
-						Stock.Insert(item.ClassName, newStock);
-						added++;
-					}
-				}
+				if (Stock.Contains(defaultClassName))
+					continue;
+
+				Stock.Insert(defaultClassName, stockDefaults.m_Stock[i]);
+				added++;
 			}
+
+			if (added)
+				EXPrint("ExpansionMarketTraderZone::Update - " + m_FileName + " - added stock for " + added + " items");
 		}
 
 		if (removed || added)
 			Save();
 	}
-}
\ No newline at end of file
+}
+
+//! Default stock of all items of the given categories, built once and applied to every trader zone (see ExpansionMarketTraderZone::Update)
+//! instead of each zone walking the categories again
+class ExpansionMarketStockDefaults
+{
+	ref TStringArray m_ClassNames = new TStringArray;
+	ref TIntArray m_Stock = new TIntArray;
+
+	void ExpansionMarketStockDefaults(map<int, ref ExpansionMarketCategory> categories)
+	{
+		foreach (ExpansionMarketCategory category : categories)
+		{
+			foreach (ExpansionMarketItem item : category.Items)
+			{
+				m_ClassNames.Insert(item.ClassName);
+
+				if (item.IsStaticStock())
+					m_Stock.Insert(1);
+				else
+					m_Stock.Insert(item.MaxStockThreshold);
+			}
+		}
+	}
+}
+
+class ExpansionMarketTraderZoneMigrationV4: ExpansionMarketMigrationStep
+{
+	override bool Apply(Class settings, string path, int fromVersion)
+	{
+		ExpansionMarketTraderZone zone = ExpansionMarketTraderZone.Cast(settings);
+
+		ExpansionMarketTraderZone zoneDefault = new ExpansionMarketTraderZone;
+		zoneDefault.Defaults();
+
+		zone.BuyPricePercent = zoneDefault.BuyPricePercent;
+
+		return true;
+	}
+}
+
+//! PricePercent was renamed to BuyPricePercent, only present in v4 files
+class ExpansionMarketTraderZoneMigrationV5: ExpansionMarketMigrationStep
+{
+	override bool Apply(Class settings, string path, int fromVersion)
+	{
+		if (fromVersion != 4)
+			return true;
+
+		ExpansionMarketTraderZone zone = ExpansionMarketTraderZone.Cast(settings);
+
+		ExpansionMarketTraderZoneV4 zoneV4;
+		if (!ExpansionJsonFileParser<ExpansionMarketTraderZoneV4>.Load( path, zoneV4 ))
+			return false;
+
+		zone.BuyPricePercent = zoneV4.PricePercent;
+
+		return true;
+	}
+}
+
+class ExpansionMarketTraderZoneMigrationV6: ExpansionMarketMigrationStep
+{
+	override bool Apply(Class settings, string path, int fromVersion)
+	{
+		ExpansionMarketTraderZone zone = ExpansionMarketTraderZone.Cast(settings);
+
+		ExpansionMarketTraderZone zoneDefault = new ExpansionMarketTraderZone;
+		zoneDefault.Defaults();
+
+		zone.SellPricePercent = zoneDefault.SellPricePercent;
+
+		return true;
+	}
+}
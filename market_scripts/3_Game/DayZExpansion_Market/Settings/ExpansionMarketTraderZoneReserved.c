@@ -21,7 +21,7 @@ class ExpansionMarketTraderZoneReserved
 		
 	void SetReservedStock( string className, int stock )
 	{
-		className.ToLower();
+		className = ExpansionMarketClassName.Normalize(className);
 
 		ExpansionMarketItem marketItem = ExpansionMarketCategory.GetGlobalItem( className );
 		if ( !marketItem )
@@ -39,7 +39,7 @@ class ExpansionMarketTraderZoneReserved
 	
 	int GetReservedStock( string className )
 	{
-		className.ToLower();
+		className = ExpansionMarketClassName.Normalize(className);
 		
 		ExpansionMarketItem marketItem = ExpansionMarketCategory.GetGlobalItem( className );
 		if ( !marketItem )
@@ -0,0 +1,230 @@
+/**
+ * ExpansionMarketValidator.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2024 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+enum ExpansionMarketValidationCheck
+{
+	CLASSNAME_NOT_FOUND,
+	ATTACHMENT_NOT_IN_MARKET,
+	CIRCULAR_ATTACHMENT,
+	UNREACHABLE_VARIANT,
+	INVERTED_PRICE_THRESHOLDS,
+	INVERTED_STOCK_THRESHOLDS,
+	TRADER_CATEGORY_NOT_FOUND,
+	TRADER_ITEM_NOT_IN_MARKET
+}
+
+class ExpansionMarketValidationIssue
+{
+	string Check;
+	string File;
+	string ClassName;
+	string Message;
+
+	void ExpansionMarketValidationIssue(ExpansionMarketValidationCheck check, string file, string className, string message)
+	{
+		Check = typename.EnumToString(ExpansionMarketValidationCheck, check);
+		File = file;
+		ClassName = className;
+		Message = message;
+	}
+}
+
+class ExpansionMarketValidationReport
+{
+	int CategoriesChecked;
+	int ItemsChecked;
+	int TradersChecked;
+	ref map<string, int> IssueCounts = new map<string, int>;
+	ref array<ref ExpansionMarketValidationIssue> Issues = new array<ref ExpansionMarketValidationIssue>;
+}
+
+/**@class		ExpansionMarketValidator
+ * @brief		Server only. Checks all loaded categories and traders once after loading (see ExpansionMarketSettings::OnLoad)
+ * and writes the found issues to EXPANSION_MARKET_VALIDATION_REPORT.
+ *
+ * Problems found here are only reported once, instead of every time an affected item is sent to clients.
+ **/
+class ExpansionMarketValidator
+{
+	ref ExpansionMarketValidationReport m_Report = new ExpansionMarketValidationReport;
+
+	//! Classname -> category file, for all items and variants
+	protected ref map<string, string> m_ItemFiles = new map<string, string>;
+
+	void Validate(map<int, ref ExpansionMarketCategory> categories, array<ref ExpansionMarketTrader> traders)
+	{
+		foreach (ExpansionMarketCategory category : categories)
+		{
+			foreach (string className, ExpansionMarketItem item : category.m_Items)
+			{
+				m_ItemFiles.Insert(className, category.m_FileName);
+			}
+		}
+
+		foreach (ExpansionMarketCategory currentCategory : categories)
+		{
+			ValidateCategory(currentCategory);
+		}
+
+		foreach (ExpansionMarketTrader trader : traders)
+		{
+			ValidateTrader(trader);
+		}
+
+		FindCircularAttachments(categories);
+	}
+
+	protected void ValidateCategory(ExpansionMarketCategory category)
+	{
+		m_Report.CategoriesChecked++;
+
+		string file = EXPANSION_MARKET_FOLDER + category.m_FileName + ".json";
+
+		foreach (string className, ExpansionMarketItem item : category.m_Items)
+		{
+			m_Report.ItemsChecked++;
+
+			if (!ClassNameExists(className))
+				AddIssue(ExpansionMarketValidationCheck.CLASSNAME_NOT_FOUND, file, className, "Class does not exist in config");
+
+			//! Variants take over thresholds of their parent, only report them once for the parent
+			if (item.m_IsVariant && item.m_StockOnly)
+				continue;
+
+			//! Max thresholds were already raised to min on load, report the values from the file
+			if (item.m_InvertedPriceThresholds)
+				AddIssue(ExpansionMarketValidationCheck.INVERTED_PRICE_THRESHOLDS, file, className, "MinPriceThreshold " + item.m_InvertedPriceThresholds[0] + " > MaxPriceThreshold " + item.m_InvertedPriceThresholds[1] + ", using " + item.MaxPriceThreshold + " as MaxPriceThreshold");
+
+			if (item.m_InvertedStockThresholds)
+				AddIssue(ExpansionMarketValidationCheck.INVERTED_STOCK_THRESHOLDS, file, className, "MinStockThreshold " + item.m_InvertedStockThresholds[0] + " > MaxStockThreshold " + item.m_InvertedStockThresholds[1] + ", using " + item.MaxStockThreshold + " as MaxStockThreshold");
+
+			foreach (string attachment : item.SpawnAttachments)
+			{
+				if (!m_ItemFiles.Contains(attachment))
+					AddIssue(ExpansionMarketValidationCheck.ATTACHMENT_NOT_IN_MARKET, file, className, "Attachment " + attachment + " does not exist in the market");
+			}
+		}
+
+		foreach (string variant, string parent : category.m_UnreachableVariants)
+		{
+			AddIssue(ExpansionMarketValidationCheck.UNREACHABLE_VARIANT, file, parent, "Variant " + variant + " is not added since it already exists in " + m_ItemFiles[variant]);
+		}
+	}
+
+	protected void ValidateTrader(ExpansionMarketTrader trader)
+	{
+		m_Report.TradersChecked++;
+
+		string file = EXPANSION_TRADER_FOLDER + trader.m_FileName + ".json";
+
+		foreach (string entry : trader.Categories)
+		{
+			string fileName = entry;
+			int separator = entry.IndexOf(":");
+			if (separator > -1)
+				fileName = entry.Substring(0, separator);
+
+			if (!GetExpansionSettings().GetMarket().GetCategory(fileName))
+				AddIssue(ExpansionMarketValidationCheck.TRADER_CATEGORY_NOT_FOUND, file, "", "Category " + fileName + " does not exist");
+		}
+
+		foreach (string className : trader.m_MissingItems)
+		{
+			AddIssue(ExpansionMarketValidationCheck.TRADER_ITEM_NOT_IN_MARKET, file, className, "Item does not exist in the market");
+		}
+	}
+
+	//! Iterative depth first search over SpawnAttachments, reports each cycle once at the attachment closing it
+	protected void FindCircularAttachments(map<int, ref ExpansionMarketCategory> categories)
+	{
+		//! 1 = on current path, 2 = done
+		map<string, int> state = new map<string, int>;
+		array<ExpansionMarketItem> path = new array<ExpansionMarketItem>;
+		TIntArray nextAttachment = new TIntArray;
+
+		foreach (ExpansionMarketCategory category : categories)
+		{
+			foreach (string className, ExpansionMarketItem root : category.m_Items)
+			{
+				if (state.Contains(className))
+					continue;
+
+				state.Insert(className, 1);
+				path.Insert(root);
+				nextAttachment.Insert(0);
+
+				while (path.Count())
+				{
+					int last = path.Count() - 1;
+					ExpansionMarketItem item = path[last];
+					int index = nextAttachment[last];
+
+					if (index >= item.SpawnAttachments.Count())
+					{
+						state.Set(item.ClassName, 2);
+						path.Remove(last);
+						nextAttachment.Remove(last);
+						continue;
+					}
+
+					nextAttachment[last] = index + 1;
+
+					string attachment = item.SpawnAttachments[index];
+					int attachmentState = state.Get(attachment);
+					if (attachmentState == 1)
+					{
+						AddIssue(ExpansionMarketValidationCheck.CIRCULAR_ATTACHMENT, EXPANSION_MARKET_FOLDER + m_ItemFiles[item.ClassName] + ".json", item.ClassName, "Attachment " + attachment + " (directly or indirectly) has " + item.ClassName + " as attachment");
+					}
+					else if (!attachmentState)
+					{
+						ExpansionMarketItem attachmentItem = ExpansionMarketCategory.GetGlobalItem(attachment, false);
+						if (attachmentItem)
+						{
+							state.Insert(attachment, 1);
+							path.Insert(attachmentItem);
+							nextAttachment.Insert(0);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	protected bool ClassNameExists(string className)
+	{
+		return GetGame().ConfigIsExisting(CFG_VEHICLESPATH + " " + className) || GetGame().ConfigIsExisting(CFG_WEAPONSPATH + " " + className) || GetGame().ConfigIsExisting(CFG_MAGAZINESPATH + " " + className);
+	}
+
+	protected void AddIssue(ExpansionMarketValidationCheck check, string file, string className, string message)
+	{
+		ExpansionMarketValidationIssue issue = new ExpansionMarketValidationIssue(check, file, className, message);
+		m_Report.Issues.Insert(issue);
+		m_Report.IssueCounts.Set(issue.Check, m_Report.IssueCounts.Get(issue.Check) + 1);
+	}
+
+	void Save()
+	{
+		JsonFileLoader<ExpansionMarketValidationReport>.JsonSaveFile(EXPANSION_MARKET_VALIDATION_REPORT, m_Report);
+	}
+
+	string ToDebugString()
+	{
+		string summary = m_Report.Issues.Count().ToString() + " issues in " + m_Report.CategoriesChecked + " categories (" + m_Report.ItemsChecked + " items) and " + m_Report.TradersChecked + " traders";
+
+		foreach (string check, int count : m_Report.IssueCounts)
+		{
+			summary += ", " + check + ": " + count;
+		}
+
+		return summary;
+	}
+}
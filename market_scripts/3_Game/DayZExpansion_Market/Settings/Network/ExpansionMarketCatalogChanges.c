@@ -0,0 +1,68 @@
+/**
+ * ExpansionMarketCatalogChanges.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2024 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+//! Categories and traders changed by reloading market files while the server is running (see ExpansionMarketSettings::ReloadFiles).
+//! Sent to clients so they drop their cached items of those categories and traders.
+class ExpansionMarketCatalogChanges
+{
+	//! Added or changed categories
+	ref array<ref ExpansionMarketNetworkCategory> m_Categories = new array<ref ExpansionMarketNetworkCategory>;
+	ref TIntArray m_RemovedCategoryIDs = new TIntArray;
+
+	//! File names of traders whose items changed
+	ref TStringArray m_Traders = new TStringArray;
+
+	//! Server only
+	int m_ItemsAdded;
+	int m_ItemsRemoved;
+	int m_ItemsModified;
+
+	bool HasChanges()
+	{
+		return m_Categories.Count() || m_RemovedCategoryIDs.Count() || m_Traders.Count();
+	}
+
+	string ToDebugString()
+	{
+		return m_Categories.Count() + " categories changed, " + m_RemovedCategoryIDs.Count() + " removed, items: " + m_ItemsAdded + " added, " + m_ItemsRemoved + " removed, " + m_ItemsModified + " modified, " + m_Traders.Count() + " traders changed";
+	}
+
+	void OnSend(ParamsWriteContext ctx)
+	{
+		ctx.Write(m_Categories);
+		ctx.Write(m_RemovedCategoryIDs);
+		ctx.Write(m_Traders);
+	}
+
+	bool OnRecieve(ParamsReadContext ctx)
+	{
+		if (!ctx.Read(m_Categories))
+		{
+			Error(ToString() + "::OnRecieve - m_Categories");
+			return false;
+		}
+
+		if (!ctx.Read(m_RemovedCategoryIDs))
+		{
+			Error(ToString() + "::OnRecieve - m_RemovedCategoryIDs");
+			return false;
+		}
+
+		if (!ctx.Read(m_Traders))
+		{
+			Error(ToString() + "::OnRecieve - m_Traders");
+			return false;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,73 @@
+/**
+ * ExpansionMarketClientCatalogCache.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2024 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+//! Client only. Items of a trader as last received in full, one file per trader, keyed by the catalog hash sent by the server
+//! (see ExpansionMarketTraderZone::GetCatalogHash). If the hash still matches when the trader menu is opened again
+//! (e.g. after reconnecting), items are added from the cache and only stock is requested from the server.
+class ExpansionMarketClientCatalogCache
+{
+	static const int VERSION = 1;
+
+	static string GetPath(string traderFileName)
+	{
+		return EXPANSION_MARKET_CLIENT_CATALOG_FOLDER + traderFileName + ".bin";
+	}
+
+	static bool Load(string traderFileName, int catalogHash, array<ref ExpansionMarketNetworkBaseItem> baseItems, array<ref ExpansionMarketNetworkItem> items)
+	{
+		string path = GetPath(traderFileName);
+		if (!FileExist(path))
+			return false;
+
+		FileSerializer file = new FileSerializer();
+		if (!file.Open(path, FileMode.READ))
+			return false;
+
+		int version;
+		int hash;
+
+		bool success = file.Read(version) && version == VERSION;
+		success = success && file.Read(hash) && hash == catalogHash;
+		success = success && ExpansionMarketNetworkItemCodec.Read(file, baseItems, items);
+
+		file.Close();
+
+		if (!success)
+		{
+			baseItems.Clear();
+			items.Clear();
+		}
+
+		return success;
+	}
+
+	static void Save(string traderFileName, int catalogHash, array<ref ExpansionMarketNetworkBaseItem> baseItems, array<ref ExpansionMarketNetworkItem> items)
+	{
+		if (!FileExist(EXPANSION_MARKET_CLIENT_CATALOG_FOLDER))
+			ExpansionStatic.MakeDirectoryRecursive(EXPANSION_MARKET_CLIENT_CATALOG_FOLDER);
+
+		string path = GetPath(traderFileName);
+
+		FileSerializer file = new FileSerializer();
+		if (!file.Open(path, FileMode.WRITE))
+		{
+			EXPrint("ExpansionMarketClientCatalogCache::Save - could not write " + path);
+			return;
+		}
+
+		file.Write(VERSION);
+		file.Write(catalogHash);
+		ExpansionMarketNetworkItemCodec.Write(file, baseItems, items);
+
+		file.Close();
+	}
+}
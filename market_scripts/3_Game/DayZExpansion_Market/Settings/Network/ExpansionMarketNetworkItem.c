@@ -42,4 +42,34 @@ class ExpansionMarketNetworkItem: ExpansionMarketNetworkBaseItem
 
 	[NonSerialized()]
 	bool m_StockOnly;
+
+	//! Combines all fields except stock into `hash` (see ExpansionMarketTraderZone::GetCatalogHash)
+	int GetCatalogHash(int hash)
+	{
+		hash = hash * 31 + ItemID;
+		hash = hash * 31 + m_StockOnly;
+
+		if (m_StockOnly)
+			return hash;
+
+		hash = hash * 31 + CategoryID;
+		hash = hash * 31 + ClassName.Hash();
+		hash = hash * 31 + MaxPriceThreshold;
+		hash = hash * 31 + MinPriceThreshold;
+		hash = hash * 31 + MaxStockThreshold;
+		hash = hash * 31 + MinStockThreshold;
+		hash = hash * 31 + Packed;
+
+		foreach (int attachmentID : AttachmentIDs)
+		{
+			hash = hash * 31 + attachmentID;
+		}
+
+		foreach (string variant : Variants)
+		{
+			hash = hash * 31 + variant.Hash();
+		}
+
+		return hash;
+	}
 };
\ No newline at end of file
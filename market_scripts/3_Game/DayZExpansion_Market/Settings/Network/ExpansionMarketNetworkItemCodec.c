@@ -0,0 +1,385 @@
+/**
+ * ExpansionMarketNetworkItemCodec.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2024 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+//! Column of ints packed into 1, 2, 4, 8, 16 or 32 bit lanes, lane width is chosen by the largest value.
+//! Signed values and deltas are zigzag encoded first so small negative values stay small.
+class ExpansionMarketNetworkIntColumn
+{
+	static int ZigZag(int value)
+	{
+		return (value << 1) ^ (value >> 31);
+	}
+
+	static int UnZigZag(int value)
+	{
+		return ((value >> 1) & 0x7fffffff) ^ -(value & 1);
+	}
+
+	static void Write(ParamsWriteContext ctx, TIntArray values)
+	{
+		int bits;
+		foreach (int value : values)
+		{
+			bits |= value;
+		}
+
+		int width = 32;
+		if (bits >= 0)
+		{
+			for (width = 1; width < 32; width *= 2)
+			{
+				if (bits < (1 << width))
+					break;
+			}
+		}
+
+		TIntArray packed = new TIntArray;
+		int perInt = 32 / width;
+		int mask = GetMask(width);
+
+		foreach (int i, int lane : values)
+		{
+			int index = i / perInt;
+			if (index == packed.Count())
+				packed.Insert(0);
+
+			packed[index] = packed[index] | ((lane & mask) << ((i % perInt) * width));
+		}
+
+		//! Count and lane width share one int
+		ctx.Write((values.Count() << 6) | width);
+		ctx.Write(packed);
+	}
+
+	static bool Read(ParamsReadContext ctx, TIntArray values)
+	{
+		int header;
+		if (!ctx.Read(header))
+			return false;
+
+		TIntArray packed;
+		if (!ctx.Read(packed))
+			return false;
+
+		int count = (header >> 6) & 0x03ffffff;
+		int width = header & 0x3f;
+		if (width != 1 && width != 2 && width != 4 && width != 8 && width != 16 && width != 32)
+			return false;
+
+		int perInt = 32 / width;
+		if (packed.Count() != (count + perInt - 1) / perInt)
+			return false;
+
+		int mask = GetMask(width);
+
+		values.Clear();
+		for (int i = 0; i < count; i++)
+		{
+			//! @note EnfScript right shift is arithmetic, apply mask after shifting
+			values.Insert((packed[i / perInt] >> ((i % perInt) * width)) & mask);
+		}
+
+		return true;
+	}
+
+	protected static int GetMask(int width)
+	{
+		if (width == 32)
+			return 0xffffffff;
+
+		return (1 << width) - 1;
+	}
+}
+
+/**@class		ExpansionMarketNetworkItemCodec
+ * @brief		Columnar encoding of a batch of trader items (see ExpansionMarketModule::LoadTraderItems).
+ *
+ * Instead of one object per item, every field is sent as one packed int column (see ExpansionMarketNetworkIntColumn).
+ * Class and variant names are sent once per batch in a string table and referenced by index, item IDs and category IDs
+ * are delta encoded (trader items are ordered by ID), whether an item has attachments or variants is sent as flag bits.
+ * Variants are referenced by name index rather than item ID since stock only variants are only known to clients by name.
+ **/
+class ExpansionMarketNetworkItemCodec
+{
+	//! Trader item RPC payload format requested by client. 0 = one object per item (clients not sending a version)
+	static const int PROTOCOL_VERSION = 1;
+
+	static const int FLAG_ATTACHMENTS = 1;
+	static const int FLAG_VARIANTS = 2;
+
+	static void Write(ParamsWriteContext ctx, array<ref ExpansionMarketNetworkBaseItem> baseItems, array<ref ExpansionMarketNetworkItem> items)
+	{
+		TStringArray strings = new TStringArray;
+		map<string, int> stringIndices = new map<string, int>;
+
+		TIntArray baseItemIDs = new TIntArray;
+		TIntArray baseStocks = new TIntArray;
+
+		int previousID;
+		foreach (ExpansionMarketNetworkBaseItem baseItem : baseItems)
+		{
+			baseItemIDs.Insert(ExpansionMarketNetworkIntColumn.ZigZag(baseItem.ItemID - previousID));
+			baseStocks.Insert(ExpansionMarketNetworkIntColumn.ZigZag(baseItem.Stock));
+			previousID = baseItem.ItemID;
+		}
+
+		TIntArray itemIDs = new TIntArray;
+		TIntArray stocks = new TIntArray;
+		TIntArray categoryIDs = new TIntArray;
+		TIntArray classNames = new TIntArray;
+		TIntArray maxPrices = new TIntArray;
+		TIntArray minPrices = new TIntArray;
+		TIntArray maxStocks = new TIntArray;
+		TIntArray minStocks = new TIntArray;
+		TIntArray packed = new TIntArray;
+		TIntArray flags = new TIntArray;
+		TIntArray attachmentCounts = new TIntArray;
+		TIntArray attachmentIDs = new TIntArray;
+		TIntArray variantCounts = new TIntArray;
+		TIntArray variantNames = new TIntArray;
+
+		previousID = 0;
+		int previousCategoryID;
+		int itemFlags;
+		foreach (ExpansionMarketNetworkItem item : items)
+		{
+			itemIDs.Insert(ExpansionMarketNetworkIntColumn.ZigZag(item.ItemID - previousID));
+			stocks.Insert(ExpansionMarketNetworkIntColumn.ZigZag(item.Stock));
+			categoryIDs.Insert(ExpansionMarketNetworkIntColumn.ZigZag(item.CategoryID - previousCategoryID));
+			classNames.Insert(Intern(item.ClassName, strings, stringIndices));
+			maxPrices.Insert(ExpansionMarketNetworkIntColumn.ZigZag(item.MaxPriceThreshold));
+			minPrices.Insert(ExpansionMarketNetworkIntColumn.ZigZag(item.MinPriceThreshold));
+			maxStocks.Insert(ExpansionMarketNetworkIntColumn.ZigZag(item.MaxStockThreshold));
+			minStocks.Insert(ExpansionMarketNetworkIntColumn.ZigZag(item.MinStockThreshold));
+			packed.Insert(item.Packed);
+
+			previousID = item.ItemID;
+			previousCategoryID = item.CategoryID;
+
+			itemFlags = 0;
+
+			if (item.AttachmentIDs && item.AttachmentIDs.Count())
+			{
+				itemFlags |= FLAG_ATTACHMENTS;
+				attachmentCounts.Insert(item.AttachmentIDs.Count());
+				foreach (int attachmentID : item.AttachmentIDs)
+				{
+					attachmentIDs.Insert(ExpansionMarketNetworkIntColumn.ZigZag(attachmentID - item.ItemID));
+				}
+			}
+
+			if (item.Variants && item.Variants.Count())
+			{
+				itemFlags |= FLAG_VARIANTS;
+				variantCounts.Insert(item.Variants.Count());
+				foreach (string variant : item.Variants)
+				{
+					variantNames.Insert(Intern(variant, strings, stringIndices));
+				}
+			}
+
+			flags.Insert(itemFlags);
+		}
+
+		ctx.Write(strings);
+
+		ExpansionMarketNetworkIntColumn.Write(ctx, baseItemIDs);
+		ExpansionMarketNetworkIntColumn.Write(ctx, baseStocks);
+
+		ExpansionMarketNetworkIntColumn.Write(ctx, itemIDs);
+		ExpansionMarketNetworkIntColumn.Write(ctx, stocks);
+		ExpansionMarketNetworkIntColumn.Write(ctx, categoryIDs);
+		ExpansionMarketNetworkIntColumn.Write(ctx, classNames);
+		ExpansionMarketNetworkIntColumn.Write(ctx, maxPrices);
+		ExpansionMarketNetworkIntColumn.Write(ctx, minPrices);
+		ExpansionMarketNetworkIntColumn.Write(ctx, maxStocks);
+		ExpansionMarketNetworkIntColumn.Write(ctx, minStocks);
+		ExpansionMarketNetworkIntColumn.Write(ctx, packed);
+		ExpansionMarketNetworkIntColumn.Write(ctx, flags);
+		ExpansionMarketNetworkIntColumn.Write(ctx, attachmentCounts);
+		ExpansionMarketNetworkIntColumn.Write(ctx, attachmentIDs);
+		ExpansionMarketNetworkIntColumn.Write(ctx, variantCounts);
+		ExpansionMarketNetworkIntColumn.Write(ctx, variantNames);
+	}
+
+	static bool Read(ParamsReadContext ctx, array<ref ExpansionMarketNetworkBaseItem> baseItems, array<ref ExpansionMarketNetworkItem> items)
+	{
+		TStringArray strings;
+		if (!ctx.Read(strings))
+			return false;
+
+		TIntArray baseItemIDs = new TIntArray;
+		TIntArray baseStocks = new TIntArray;
+
+		if (!ExpansionMarketNetworkIntColumn.Read(ctx, baseItemIDs) || !ExpansionMarketNetworkIntColumn.Read(ctx, baseStocks))
+			return false;
+
+		if (baseStocks.Count() != baseItemIDs.Count())
+			return false;
+
+		TIntArray itemIDs = new TIntArray;
+		TIntArray stocks = new TIntArray;
+		TIntArray categoryIDs = new TIntArray;
+		TIntArray classNames = new TIntArray;
+		TIntArray maxPrices = new TIntArray;
+		TIntArray minPrices = new TIntArray;
+		TIntArray maxStocks = new TIntArray;
+		TIntArray minStocks = new TIntArray;
+		TIntArray packed = new TIntArray;
+		TIntArray flags = new TIntArray;
+		TIntArray attachmentCounts = new TIntArray;
+		TIntArray attachmentIDs = new TIntArray;
+		TIntArray variantCounts = new TIntArray;
+		TIntArray variantNames = new TIntArray;
+
+		array<TIntArray> columns = {itemIDs, stocks, categoryIDs, classNames, maxPrices, minPrices, maxStocks, minStocks, packed, flags};
+		foreach (TIntArray column : columns)
+		{
+			if (!ExpansionMarketNetworkIntColumn.Read(ctx, column) || column.Count() != itemIDs.Count())
+				return false;
+		}
+
+		if (!ExpansionMarketNetworkIntColumn.Read(ctx, attachmentCounts) || !ExpansionMarketNetworkIntColumn.Read(ctx, attachmentIDs))
+			return false;
+
+		if (!ExpansionMarketNetworkIntColumn.Read(ctx, variantCounts) || !ExpansionMarketNetworkIntColumn.Read(ctx, variantNames))
+			return false;
+
+		int itemID;
+		foreach (int i, int baseItemID : baseItemIDs)
+		{
+			itemID += ExpansionMarketNetworkIntColumn.UnZigZag(baseItemID);
+			baseItems.Insert(new ExpansionMarketNetworkBaseItem(itemID, ExpansionMarketNetworkIntColumn.UnZigZag(baseStocks[i])));
+		}
+
+		itemID = 0;
+		int categoryID;
+		int attachmentIndex;
+		int attachmentCountIndex;
+		int variantIndex;
+		int variantCountIndex;
+		for (int j = 0; j < itemIDs.Count(); j++)
+		{
+			itemID += ExpansionMarketNetworkIntColumn.UnZigZag(itemIDs[j]);
+			categoryID += ExpansionMarketNetworkIntColumn.UnZigZag(categoryIDs[j]);
+
+			if (classNames[j] >= strings.Count())
+				return false;
+
+			ExpansionMarketNetworkItem item = new ExpansionMarketNetworkItem(itemID, ExpansionMarketNetworkIntColumn.UnZigZag(stocks[j]));
+			item.CategoryID = categoryID;
+			item.ClassName = strings[classNames[j]];
+			item.MaxPriceThreshold = ExpansionMarketNetworkIntColumn.UnZigZag(maxPrices[j]);
+			item.MinPriceThreshold = ExpansionMarketNetworkIntColumn.UnZigZag(minPrices[j]);
+			item.MaxStockThreshold = ExpansionMarketNetworkIntColumn.UnZigZag(maxStocks[j]);
+			item.MinStockThreshold = ExpansionMarketNetworkIntColumn.UnZigZag(minStocks[j]);
+			item.Packed = packed[j];
+			item.AttachmentIDs = new TIntArray;
+			item.Variants = new TStringArray;
+
+			int count;
+			int k;
+
+			if (flags[j] & FLAG_ATTACHMENTS)
+			{
+				if (attachmentCountIndex >= attachmentCounts.Count())
+					return false;
+
+				count = attachmentCounts[attachmentCountIndex++];
+				if (attachmentIndex + count > attachmentIDs.Count())
+					return false;
+
+				for (k = 0; k < count; k++)
+				{
+					item.AttachmentIDs.Insert(itemID + ExpansionMarketNetworkIntColumn.UnZigZag(attachmentIDs[attachmentIndex++]));
+				}
+			}
+
+			if (flags[j] & FLAG_VARIANTS)
+			{
+				if (variantCountIndex >= variantCounts.Count())
+					return false;
+
+				count = variantCounts[variantCountIndex++];
+				if (variantIndex + count > variantNames.Count())
+					return false;
+
+				for (k = 0; k < count; k++)
+				{
+					int variantName = variantNames[variantIndex++];
+					if (variantName >= strings.Count())
+						return false;
+
+					item.Variants.Insert(strings[variantName]);
+				}
+			}
+
+			items.Insert(item);
+		}
+
+		return true;
+	}
+
+#ifdef EXPANSIONMODMARKET_DEBUG
+	//! Rough payload size of a batch as one object per item vs. columnar, ints and string lengths count 4 bytes each
+	static string GetSizeComparison(array<ref ExpansionMarketNetworkBaseItem> baseItems, array<ref ExpansionMarketNetworkItem> items)
+	{
+		int legacy = 8 + baseItems.Count() * 8;
+		map<string, bool> strings = new map<string, bool>;
+		int stringBytes;
+
+		foreach (ExpansionMarketNetworkItem item : items)
+		{
+			legacy += 40 + item.ClassName.Length();
+			AddStringSize(item.ClassName, strings, stringBytes);
+
+			if (item.AttachmentIDs)
+				legacy += item.AttachmentIDs.Count() * 4;
+
+			if (!item.Variants)
+				continue;
+
+			foreach (string variant : item.Variants)
+			{
+				legacy += 4 + variant.Length();
+				AddStringSize(variant, strings, stringBytes);
+			}
+		}
+
+		//! Ten columns per item (mostly 8 or 16 bit lanes after delta/zigzag), rough estimate at 16 bits each
+		int columnar = 4 + stringBytes + 16 * 8 + baseItems.Count() * 4 + items.Count() * 20;
+
+		return "~" + legacy + " bytes per object vs. ~" + columnar + " bytes columnar (" + items.Count() + " items, " + baseItems.Count() + " stock only items, " + strings.Count() + " unique names)";
+	}
+
+	protected static void AddStringSize(string value, map<string, bool> strings, inout int stringBytes)
+	{
+		if (strings.Contains(value))
+			return;
+
+		strings.Insert(value, true);
+		stringBytes += 4 + value.Length();
+	}
+#endif
+
+	protected static int Intern(string value, TStringArray strings, map<string, int> stringIndices)
+	{
+		int index;
+		if (!stringIndices.Find(value, index))
+		{
+			index = strings.Insert(value);
+			stringIndices.Insert(value, index);
+		}
+
+		return index;
+	}
+}
@@ -24,7 +24,7 @@ class ExpansionMarketClientTraderZone: ExpansionMarketTraderZone
 
 	override void RemoveStock( string className, int stock, bool inReserve = false )
 	{
-		className.ToLower();
+		className = ExpansionMarketClassName.Normalize(className);
 
 		//! Print("[ExpansionMarketClientTraderZone] RemoveStock " + m_FileName + " " + className + " " + stock);
 
@@ -66,7 +66,7 @@ class ExpansionMarketClientTraderZone: ExpansionMarketTraderZone
 
 	override int GetStock( string className, bool actual = false )
 	{
-		className.ToLower();
+		className = ExpansionMarketClassName.Normalize(className);
 
 		if ( !ItemExists( className ) )
 			return ExpansionMarketStock.Undefined;
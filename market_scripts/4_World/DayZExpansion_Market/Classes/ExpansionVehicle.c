@@ -1,6 +1,32 @@
 modded class ExpansionVehicle
 {
 	protected int m_ParkingFine;
+	protected ref ExpansionMarketParkingFineEntry m_ParkingFineEntry;
+
+	ExpansionMarketParkingFineEntry Expansion_GetParkingFineEntry(bool create = true)
+	{
+		if (!m_ParkingFineEntry && create)
+			m_ParkingFineEntry = new ExpansionMarketParkingFineEntry(this);
+
+		return m_ParkingFineEntry;
+	}
+
+	//! True if vehicle is parked in a safezone without fine yet, i.e. EvaluateSafeZoneParkingFine could set one eventually
+	bool IsParkingFineCandidate()
+	{
+		return m_IsInSafeZone && m_SZParkingTime && m_ParkingFine <= 0 && GetExpansionSettings().GetMarket().SZVehicleParkingTicketFine > 0;
+	}
+
+	//! Milliseconds until max allowed parking time in SZ is exceeded
+	int GetParkingFineDelay()
+	{
+		if (GetLockState() == ExpansionVehicleLockState.FORCEDLOCKED)
+			return 0;
+
+		float remaining = GetExpansionSettings().GetMarket().MaxSZVehicleParkingTime - m_SZParkingTime;
+
+		return Math.Max(remaining, 0) * 1000;
+	}
 
 	void EvaluateSafeZoneParkingFine()
 	{
@@ -94,29 +94,9 @@ class ExpansionActionPayParkingFine: ActionInteractBase
 		ExpansionVehicle vehicle;
 		if (ExpansionVehicle.Get(vehicle, action_data.m_Target.GetParentOrObject()) || ExpansionVehicle.Get(vehicle, player))
 		{
-			int amount = vehicle.GetParkingFine();
-			ExpansionMarketModule market = ExpansionMarketModule.GetInstance();
-
-			TIntArray monies = {};
-			if (market.FindMoneyAndCountTypes(player, amount, monies, true))
-			{
-				int removed = market.RemoveMoney(player);
-				if (removed - amount > 0)
-				{
-					EntityAI parent = player;
-					market.SpawnMoney(player, parent, removed - amount, true);
-					market.CheckSpawn(player, parent);
-				}
-
-				vehicle.ForceUnlock(ExpansionVehicleLockState.UNLOCKED);
-				vehicle.SetParkingFine(0);
-				vehicle.ResetSZParkingTime();
-			}
-			else
-			{
+			array<ExpansionVehicle> vehicles = {vehicle};
+			if (!ExpansionMarketParkingFineEngine.GetInstance().PayParkingFines(player, vehicles))
 				ExpansionNotification("STR_EXPANSION_MARKET_TITLE", "STR_EXPANSION_TRADER_NOT_ENOGH_MONEY").Error(player.GetIdentity());
-				market.UnlockMoney(player);
-			}
 		}
 	}
 }
@@ -5,7 +5,15 @@ modded class CarScript
 	{
 		super.OnCEUpdate();
 
-		m_ExpansionVehicle.EvaluateSafeZoneParkingFine();
+		ExpansionMarketParkingFineEngine.GetInstance().Track(m_ExpansionVehicle);
+	}
+
+	override void EEDelete(EntityAI parent)
+	{
+		super.EEDelete(parent);
+
+		if (m_ExpansionVehicle && ExpansionGame.IsServerOrOffline())
+			ExpansionMarketParkingFineEngine.GetInstance().Untrack(m_ExpansionVehicle);
 	}
 
 	void Expansion_EvaluateSafeZoneParkingFine()
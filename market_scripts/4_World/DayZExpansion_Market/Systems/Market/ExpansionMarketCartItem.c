@@ -0,0 +1,68 @@
+/**
+ * ExpansionMarketCartItem.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2024 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+//! One line item of a batched market purchase (see ExpansionMarketModule::RequestPurchaseCart)
+class ExpansionMarketCartItem
+{
+	int ItemID;
+	int Count;
+	int Price;
+	bool IncludeAttachments = true;
+	int SkinIndex = -1;
+	ref TIntArray AttachmentIDs;
+
+	//! Server
+	ref ExpansionMarketReserve Reserve;
+
+	void ExpansionMarketCartItem(int itemID = 0, int count = 0, int price = 0, bool includeAttachments = true, int skinIndex = -1, TIntArray attachmentIDs = NULL)
+	{
+		ItemID = itemID;
+		Count = count;
+		Price = price;
+		IncludeAttachments = includeAttachments;
+		SkinIndex = skinIndex;
+		AttachmentIDs = attachmentIDs;
+	}
+
+	void OnSend(ParamsWriteContext ctx)
+	{
+		ctx.Write(ItemID);
+		ctx.Write(Count);
+		ctx.Write(Price);
+		ctx.Write(IncludeAttachments);
+		ctx.Write(SkinIndex);
+		ctx.Write(AttachmentIDs);
+	}
+
+	bool OnRecieve(ParamsReadContext ctx)
+	{
+		if (!ctx.Read(ItemID))
+			return false;
+
+		if (!ctx.Read(Count))
+			return false;
+
+		if (!ctx.Read(Price))
+			return false;
+
+		if (!ctx.Read(IncludeAttachments))
+			return false;
+
+		if (!ctx.Read(SkinIndex))
+			return false;
+
+		if (!ctx.Read(AttachmentIDs))
+			return false;
+
+		return true;
+	}
+}
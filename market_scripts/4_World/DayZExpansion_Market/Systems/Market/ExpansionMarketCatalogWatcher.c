@@ -0,0 +1,145 @@
+/**
+ * ExpansionMarketCatalogWatcher.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2024 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+//! Server only. JSON files of one watched folder and hashes of their contents as of the last scan.
+class ExpansionMarketWatchedFolder
+{
+	string m_Path;
+
+	protected ref map<string, int> m_Hashes = new map<string, int>;
+
+	//! File names (without extension) found by the current scan
+	ref TStringArray m_Files = new TStringArray;
+
+	//! Files changed or added/removed since the last scan
+	ref TStringArray m_Changed = new TStringArray;
+	ref TStringArray m_Removed = new TStringArray;
+
+	void ExpansionMarketWatchedFolder(string path)
+	{
+		m_Path = path;
+	}
+
+	void StartScan()
+	{
+		m_Files.Clear();
+		m_Changed.Clear();
+		m_Removed.Clear();
+
+		array<string> fileNames = ExpansionStatic.FindFilesInLocation(m_Path, ".json", true);
+		foreach (string fileName : fileNames)
+		{
+			//! Strip '.json' extension
+			m_Files.Insert(fileName.Substring(0, fileName.Length() - 5));
+		}
+	}
+
+	void CheckFile(string fileName)
+	{
+		int hash = ExpansionMarketCatalogSnapshot.GetFileHash(m_Path + fileName + ".json");
+
+		int previous;
+		if (m_Hashes.Find(fileName, previous) && previous == hash)
+			return;
+
+		m_Hashes.Set(fileName, hash);
+		m_Changed.Insert(fileName);
+	}
+
+	void EndScan()
+	{
+		foreach (string fileName, int hash : m_Hashes)
+		{
+			if (m_Files.Find(fileName) == -1)
+				m_Removed.Insert(fileName);
+		}
+
+		foreach (string removed : m_Removed)
+		{
+			m_Hashes.Remove(removed);
+		}
+	}
+
+	bool HasChanges()
+	{
+		return m_Changed.Count() || m_Removed.Count();
+	}
+}
+
+//! Server only. Polls the market category and trader folders for changed files, hashing a few files per tick.
+//! File times are not available to script, so files are compared by a hash of their contents.
+//! The first scan only records the files as loaded on mission start.
+class ExpansionMarketCatalogWatcher
+{
+	//! ms between the end of a scan and the start of the next
+	static const int POLL_INTERVAL = 10000;
+
+	static const int FILES_PER_TICK = 4;
+
+	ref ExpansionMarketWatchedFolder m_Categories = new ExpansionMarketWatchedFolder(EXPANSION_MARKET_FOLDER);
+	ref ExpansionMarketWatchedFolder m_Traders = new ExpansionMarketWatchedFolder(EXPANSION_TRADER_FOLDER);
+
+	protected ExpansionMarketWatchedFolder m_Folder;
+	protected int m_NextFile;
+	protected int m_NextScanTime;
+	protected int m_ScanCount;
+
+	//! @return true once a scan completed that found changed files
+	bool Tick(int time)
+	{
+		if (!m_Folder)
+		{
+			if (time < m_NextScanTime)
+				return false;
+
+			m_Categories.StartScan();
+			m_Traders.StartScan();
+
+			m_Folder = m_Categories;
+			m_NextFile = 0;
+		}
+
+		int checkedFiles;
+		while (checkedFiles < FILES_PER_TICK)
+		{
+			if (m_NextFile >= m_Folder.m_Files.Count())
+			{
+				if (m_Folder == m_Traders)
+					return EndScan(time);
+
+				m_Folder = m_Traders;
+				m_NextFile = 0;
+				continue;
+			}
+
+			m_Folder.CheckFile(m_Folder.m_Files[m_NextFile++]);
+			checkedFiles++;
+		}
+
+		return false;
+	}
+
+	protected bool EndScan(int time)
+	{
+		m_Categories.EndScan();
+		m_Traders.EndScan();
+
+		m_Folder = null;
+		m_NextScanTime = time + POLL_INTERVAL;
+
+		//! Files as loaded on mission start
+		if (!m_ScanCount++)
+			return false;
+
+		return m_Categories.HasChanges() || m_Traders.HasChanges();
+	}
+}
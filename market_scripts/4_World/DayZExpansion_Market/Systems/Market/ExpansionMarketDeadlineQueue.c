@@ -0,0 +1,179 @@
+/**
+ * ExpansionMarketDeadlineQueue.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2024 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+class ExpansionMarketDeadlineEntry
+{
+	int Deadline;
+
+	//! Position in the queue heap, -1 if not queued
+	int HeapIndex = -1;
+
+	bool IsQueued()
+	{
+		return HeapIndex > -1;
+	}
+}
+
+//! Min-heap of entries ordered by deadline. Insert, remove and update are O(log n), peek is O(1).
+class ExpansionMarketDeadlineQueue
+{
+	protected ref array<ref ExpansionMarketDeadlineEntry> m_Heap;
+
+	void ExpansionMarketDeadlineQueue()
+	{
+		m_Heap = new array<ref ExpansionMarketDeadlineEntry>;
+	}
+
+	void Insert(ExpansionMarketDeadlineEntry entry)
+	{
+		if (entry.IsQueued())
+		{
+			Update(entry, entry.Deadline);
+			return;
+		}
+
+		entry.HeapIndex = m_Heap.Insert(entry);
+		SiftUp(entry.HeapIndex);
+	}
+
+	void Update(ExpansionMarketDeadlineEntry entry, int deadline)
+	{
+		if (!entry.IsQueued())
+		{
+			entry.Deadline = deadline;
+			Insert(entry);
+			return;
+		}
+
+		int previous = entry.Deadline;
+		entry.Deadline = deadline;
+
+		if (deadline < previous)
+			SiftUp(entry.HeapIndex);
+		else
+			SiftDown(entry.HeapIndex);
+	}
+
+	bool Remove(ExpansionMarketDeadlineEntry entry)
+	{
+		if (!entry.IsQueued())
+			return false;
+
+		RemoveAt(entry.HeapIndex);
+
+		return true;
+	}
+
+	//! Returns entry with the earliest deadline if it is at or before `time`, NULL otherwise
+	ExpansionMarketDeadlineEntry PopExpired(int time)
+	{
+		if (!m_Heap.Count() || m_Heap[0].Deadline > time)
+			return NULL;
+
+		ExpansionMarketDeadlineEntry entry = m_Heap[0];
+		RemoveAt(0);
+
+		return entry;
+	}
+
+	ExpansionMarketDeadlineEntry Peek()
+	{
+		if (!m_Heap.Count())
+			return NULL;
+
+		return m_Heap[0];
+	}
+
+	int Count()
+	{
+		return m_Heap.Count();
+	}
+
+	void Clear()
+	{
+		foreach (ExpansionMarketDeadlineEntry entry: m_Heap)
+		{
+			entry.HeapIndex = -1;
+		}
+
+		m_Heap.Clear();
+	}
+
+	protected void RemoveAt(int index)
+	{
+		ExpansionMarketDeadlineEntry entry = m_Heap[index];
+		entry.HeapIndex = -1;
+
+		int last = m_Heap.Count() - 1;
+		if (index != last)
+		{
+			SetAt(index, m_Heap[last]);
+			m_Heap.Remove(last);
+
+			if (index > 0 && m_Heap[index].Deadline < m_Heap[(index - 1) / 2].Deadline)
+				SiftUp(index);
+			else
+				SiftDown(index);
+		}
+		else
+		{
+			m_Heap.Remove(last);
+		}
+	}
+
+	protected void SetAt(int index, ExpansionMarketDeadlineEntry entry)
+	{
+		m_Heap[index] = entry;
+		entry.HeapIndex = index;
+	}
+
+	protected void SiftUp(int index)
+	{
+		ExpansionMarketDeadlineEntry entry = m_Heap[index];
+
+		while (index > 0)
+		{
+			int parent = (index - 1) / 2;
+			if (m_Heap[parent].Deadline <= entry.Deadline)
+				break;
+
+			SetAt(index, m_Heap[parent]);
+			index = parent;
+		}
+
+		SetAt(index, entry);
+	}
+
+	protected void SiftDown(int index)
+	{
+		ExpansionMarketDeadlineEntry entry = m_Heap[index];
+		int count = m_Heap.Count();
+
+		while (true)
+		{
+			int child = index * 2 + 1;
+			if (child >= count)
+				break;
+
+			if (child + 1 < count && m_Heap[child + 1].Deadline < m_Heap[child].Deadline)
+				child++;
+
+			if (entry.Deadline <= m_Heap[child].Deadline)
+				break;
+
+			SetAt(index, m_Heap[child]);
+			index = child;
+		}
+
+		SetAt(index, entry);
+	}
+}
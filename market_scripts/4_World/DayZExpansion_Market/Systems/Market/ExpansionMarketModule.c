@@ -277,12 +277,14 @@ class ExpansionMarketPlayerInventory
 class ExpansionMarketModule: CF_ModuleWorld
 {
 	static const float MAX_TRADER_INTERACTION_DISTANCE = 5;
+	static const int MAX_CART_ITEMS = 50;
 
 	static ref ExpansionMarketModule s_Instance;
 
 	static ref ScriptInvoker SI_SetTraderInvoker = new ScriptInvoker();
 	static ref ScriptInvoker SI_SelectedItemUpdatedInvoker = new ScriptInvoker();
 	static ref ScriptInvoker SI_Callback = new ScriptInvoker();
+	static ref ScriptInvoker SI_CartCallback = new ScriptInvoker();
 	static ref ScriptInvoker SI_ATMMenuInvoker = new ScriptInvoker();
 	static ref ScriptInvoker SI_ATMMenuCallback = new ScriptInvoker();
 	static ref ScriptInvoker SI_ATMMenuTransferCallback = new ScriptInvoker();
@@ -294,6 +296,9 @@ class ExpansionMarketModule: CF_ModuleWorld
 	protected int m_TmpVariantIdIdx;
 	protected ref map<int, ref ExpansionMarketCategory> m_TmpNetworkCats;
 	protected ref array<ref ExpansionMarketNetworkBaseItem> m_TmpNetworkBaseItems;
+	protected int m_ClientCatalogHash;
+	protected ref array<ref ExpansionMarketNetworkBaseItem> m_ClientCatalogBaseItems;
+	protected ref array<ref ExpansionMarketNetworkItem> m_ClientCatalogItems;
 	protected int m_PlayerWorth;
 
 	ref map<string, int> m_MoneyTypes;
@@ -310,6 +315,11 @@ class ExpansionMarketModule: CF_ModuleWorld
 
 	static ref map<string, string> s_AmmoBullets = new map<string, string>;
 
+	//! Server
+	protected ref ExpansionMarketReservationScheduler m_ReservationScheduler;
+	protected ref array<ref ExpansionMarketReservationEntry> m_ExpiredReservations;
+	protected ref ExpansionMarketCatalogWatcher m_CatalogWatcher;
+
 	// ------------------------------------------------------------
 	// ExpansionMarketModule Constructor
 	// ------------------------------------------------------------	
@@ -320,6 +330,8 @@ class ExpansionMarketModule: CF_ModuleWorld
 		m_TmpVariantIds = new TIntArray;
 		m_TmpNetworkCats = new map<int, ref ExpansionMarketCategory>;
 		m_TmpNetworkBaseItems = new array<ref ExpansionMarketNetworkBaseItem>;
+		m_ClientCatalogBaseItems = new array<ref ExpansionMarketNetworkBaseItem>;
+		m_ClientCatalogItems = new array<ref ExpansionMarketNetworkItem>;
 
 		m_MoneyTypes = new map<string, int>;
 		m_MoneyDenominations = new array<string>;
@@ -329,6 +341,9 @@ class ExpansionMarketModule: CF_ModuleWorld
 		m_ClientMarketZone = new ExpansionMarketClientTraderZone;
 
 		m_ATMData = new array<ref ExpansionMarketATM_Data>;
+
+		m_ReservationScheduler = new ExpansionMarketReservationScheduler;
+		m_ExpiredReservations = new array<ref ExpansionMarketReservationEntry>;
 	}
 	
 	static ExpansionMarketModule GetInstance()
@@ -347,11 +362,14 @@ class ExpansionMarketModule: CF_ModuleWorld
 		EnableInvokeConnect();
 		EnableMissionFinish();
 		EnableMissionLoaded();
+		EnableUpdate();
 		Expansion_EnableRPCManager();
 
 		Expansion_RegisterClientRPC("RPC_Callback");
 		Expansion_RegisterClientRPC("RPC_MoneyDenominations");
 		Expansion_RegisterServerRPC("RPC_RequestPurchase");
+		Expansion_RegisterServerRPC("RPC_RequestPurchaseCart");
+		Expansion_RegisterClientRPC("RPC_CartCallback");
 		Expansion_RegisterServerRPC("RPC_CancelPurchase");
 		Expansion_RegisterServerRPC("RPC_RequestSell");
 		Expansion_RegisterServerRPC("RPC_CancelSell");
@@ -359,6 +377,7 @@ class ExpansionMarketModule: CF_ModuleWorld
 		Expansion_RegisterClientRPC("RPC_LoadTraderData");
 		Expansion_RegisterServerRPC("RPC_RequestTraderItems");
 		Expansion_RegisterClientRPC("RPC_LoadTraderItems");
+		Expansion_RegisterClientRPC("RPC_CatalogChanged");
 		Expansion_RegisterServerRPC("RPC_ExitTrader");
 		Expansion_RegisterServerRPC("RPC_RequestPlayerATMData");
 		Expansion_RegisterClientRPC("RPC_SendPlayerATMData");
@@ -433,6 +452,9 @@ class ExpansionMarketModule: CF_ModuleWorld
 			return;
 		
 		LoadMoneyPrice();
+
+		if (GetExpansionSettings().GetMarket().MarketSystemEnabled)
+			m_CatalogWatcher = new ExpansionMarketCatalogWatcher;
 	}
 	
 	// ------------------------------------------------------------
@@ -465,6 +487,93 @@ class ExpansionMarketModule: CF_ModuleWorld
 		}
 	}
 
+	// ------------------------------------------------------------
+	// Override OnUpdate
+	// ------------------------------------------------------------
+	override void OnUpdate(Class sender, CF_EventArgs args)
+	{
+		super.OnUpdate(sender, args);
+
+		//! Dedicated server, or offline/singleplayer where the client is also the host
+		if (!ExpansionGame.IsServerOrOffline())
+			return;
+
+		int time = GetGame().GetTime();
+
+	#ifdef EXPANSIONMODVEHICLE
+		ExpansionMarketParkingFineEngine.GetInstance().Tick(time);
+	#endif
+
+		if (m_CatalogWatcher && m_CatalogWatcher.Tick(time))
+			ReloadCatalog();
+
+		if (!m_ReservationScheduler.PopExpired(time, m_ExpiredReservations))
+			return;
+
+		foreach (ExpansionMarketReservationEntry entry: m_ExpiredReservations)
+		{
+			ExpireReservation(entry);
+		}
+
+		m_ExpiredReservations.Clear();
+
+		MarketModulePrint("OnUpdate - Reservations: " + m_ReservationScheduler.GetMetrics());
+	}
+
+	ExpansionMarketReservationScheduler GetReservationScheduler()
+	{
+		return m_ReservationScheduler;
+	}
+
+	//! @note server. Applies category and trader files changed since the last scan, tells clients to drop outdated cached items
+	protected void ReloadCatalog()
+	{
+		int start = TickCount(0);
+
+		ExpansionMarketWatchedFolder categories = m_CatalogWatcher.m_Categories;
+		ExpansionMarketWatchedFolder traders = m_CatalogWatcher.m_Traders;
+
+		ExpansionMarketCatalogChanges changes = GetExpansionSettings().GetMarket().ReloadFiles(categories.m_Changed, categories.m_Removed, traders.m_Changed, traders.m_Removed);
+
+		EXPrint(ToString() + "::ReloadCatalog - " + changes.ToDebugString() + " in " + (TickCount(start) / 10000.0) + " ms");
+
+		if (!changes.HasChanges())
+			return;
+
+		auto rpc = Expansion_CreateRPC("RPC_CatalogChanged");
+		changes.OnSend(rpc);
+		rpc.Expansion_Send(true);
+	}
+
+	//! @note client
+	private void RPC_CatalogChanged(PlayerIdentity senderRPC, Object target, ParamsReadContext ctx)
+	{
+#ifdef EXTRACE
+		auto trace = EXTrace.Start(EXTrace.MARKET, this);
+#endif
+
+		//! Host already has the reloaded items
+		if (IsMissionHost())
+			return;
+
+		ExpansionMarketCatalogChanges changes = new ExpansionMarketCatalogChanges;
+		if (!changes.OnRecieve(ctx))
+			return;
+
+		auto settings = GetExpansionSettings().GetMarket(false);
+		if (!settings.IsLoaded())
+			return;
+
+		settings.ApplyCatalogChanges(changes);
+
+		//! Items of a trader load in progress may be outdated, don't cache them
+		m_ClientCatalogHash = 0;
+
+		//! Items of the open trader menu were dropped, request them again in full
+		if (m_OpenedClientTrader && !m_OpenedClientTrader.GetTraderMarket().m_StockOnly)
+			RequestTraderItems(m_OpenedClientTrader);
+	}
+
 	// ------------------------------------------------------------
 	// Expansion GetClientZone
 	// ------------------------------------------------------------
@@ -673,8 +782,7 @@ class ExpansionMarketModule: CF_ModuleWorld
 
 		foreach (EntityAI itemEntity: items) 
 		{
-			string itemClassName = itemEntity.GetType();
-			itemClassName.ToLower();
+			string itemClassName = ExpansionMarketClassName.Normalize(itemEntity.GetType());
 			
 			itemClassName = GetMarketItemClassName(sell.Trader.GetTraderMarket(), itemClassName);
 
@@ -921,8 +1029,7 @@ class ExpansionMarketModule: CF_ModuleWorld
 			if (!attachmentEntity)
 				continue;
 
-			string attachmentName = attachmentEntity.GetType();
-			attachmentName.ToLower();
+			string attachmentName = ExpansionMarketClassName.Normalize(attachmentEntity.GetType());
 
 			attachmentName = GetMarketItemClassName(sell.Trader.GetTraderMarket(), attachmentName);
 
@@ -1159,7 +1266,7 @@ class ExpansionMarketModule: CF_ModuleWorld
 				else if (isCfgMagazineSkin)
 					GetGame().ConfigGetText("CfgMagazines " + itemClassName + " skinBase", itemClassName);
 
-				itemClassName.ToLower();
+				itemClassName = ExpansionMarketClassName.Normalize(itemClassName);
 			}
 		}
 
@@ -1638,8 +1745,7 @@ class ExpansionMarketModule: CF_ModuleWorld
 			{
 				if (Class.CastTo(existingMoney, item) && existingMoney.ExpansionIsMoney())
 				{
-					string existingType = existingMoney.GetType();
-					existingType.ToLower();
+					string existingType = ExpansionMarketClassName.Normalize(existingMoney.GetType());
 
 					//! Ignore currencies this trader/ATM does not accept
 					if (currencies && currencies.Find(existingType) == -1)
@@ -1837,8 +1943,7 @@ class ExpansionMarketModule: CF_ModuleWorld
 					}
 				#endif
 
-					string type = money.GetType();
-					type.ToLower();
+					string type = ExpansionMarketClassName.Normalize(money.GetType());
 
 					//! Ignore currencies this trader/ATM does not accept
 					if (currencies && currencies.Find(type) == -1)
@@ -2066,8 +2171,7 @@ class ExpansionMarketModule: CF_ModuleWorld
 				if (!MiscGameplayFunctions.Expansion_IsLooseEntity(money))
 					continue;
 
-				string type = money.GetType();
-				type.ToLower();
+				string type = ExpansionMarketClassName.Normalize(money.GetType());
 				
 				//! Always include all money types the player has, even if trader/ATM would not accept
 				int idx = m_MoneyDenominations.Find(type);
@@ -2144,8 +2248,7 @@ class ExpansionMarketModule: CF_ModuleWorld
 			ItemBase money;
 			if (Class.CastTo(money, items[j]) && money.ExpansionIsMoney())
 			{
-				string type = money.GetType();
-				type.ToLower();
+				string type = ExpansionMarketClassName.Normalize(money.GetType());
 
 				int idx = m_MoneyDenominations.Find(type);
 				MarketModulePrint("GetMoneyBases - idx: " + idx);
@@ -2219,8 +2322,7 @@ class ExpansionMarketModule: CF_ModuleWorld
 				int quantity = money.GetQuantity() - removeAmount;
 				if (removeAmount)
 				{
-					string type = money.GetType();
-					type.ToLower();
+					string type = ExpansionMarketClassName.Normalize(money.GetType());
 					removed += removeAmount * GetMoneyPrice(type);
 					MarketModulePrint("RemoveMoney - Removed " + removeAmount + " from " + money);
 				}
@@ -2265,18 +2367,49 @@ class ExpansionMarketModule: CF_ModuleWorld
 				if (player.IsMarketItemReserved(itemClassName))
 				{
 					EXPrint("RemoveReservedStock: FailedReserveTime");
-					
-					UnlockMoney(player);
-					
-					reserve.ClearReserved(reserve.Trader.GetTraderZone());
-		
-					Callback(reserve.RootItem.ClassName, ExpansionMarketResult.FailedReserveTime, player.GetIdentity());
-		
-					player.ClearMarketReserve();
+
+					m_ReservationScheduler.Cancel(reserve.Token);
+
+					ReleaseReservation(player, reserve);
 				}
 			}
 		}
 	}
+
+	// ------------------------------------------------------------
+	// Expansion ExpireReservation
+	// ------------------------------------------------------------
+	//! Called by OnUpdate for reservations whose deadline has passed
+	protected void ExpireReservation(ExpansionMarketReservationEntry entry)
+	{
+#ifdef EXTRACE
+		auto trace = EXTrace.Start(EXTrace.MARKET, this);
+#endif
+
+		if (!entry.Player)
+			return;
+
+		ExpansionMarketReserve reserve = entry.Player.GetMarketReserve();
+
+		//! Token mismatch means the player has made a new reservation since
+		if (!reserve || !reserve.Valid || reserve.Token != entry.Token)
+			return;
+
+		EXPrint("ExpireReservation: FailedReserveTime");
+
+		ReleaseReservation(entry.Player, reserve);
+	}
+
+	protected void ReleaseReservation(PlayerBase player, ExpansionMarketReserve reserve)
+	{
+		UnlockMoney(player);
+
+		reserve.ClearReserved(reserve.Trader.GetTraderZone());
+
+		Callback(reserve.RootItem.ClassName, ExpansionMarketResult.FailedReserveTime, player.GetIdentity());
+
+		player.ClearMarketReserve();
+	}
 	
 	/*
 	 * Called Server Only: 
@@ -2523,6 +2656,80 @@ class ExpansionMarketModule: CF_ModuleWorld
 		Exec_RequestPurchase(player, itemID, count, currentPrice, trader, includeAttachments, skinIndex, attachmentIDs);
 	}
 	
+	//! Client only
+	//! Buy several items in one request. The server either reserves stock for all lines or fails the whole cart,
+	//! result is reported through SI_CartCallback.
+	void RequestPurchaseCart(array<ref ExpansionMarketCartItem> cart, ExpansionTraderObjectBase trader)
+	{
+#ifdef EXTRACE
+		auto trace = EXTrace.Start(EXTrace.MARKET, this);
+#endif
+
+		if (!GetGame().IsDedicatedServer())
+		{
+			if (!trader)
+			{
+				EXError.Error(this, "trader is NULL");
+				return;
+			}
+
+			if (!cart.Count() || cart.Count() > MAX_CART_ITEMS)
+			{
+				EXError.Error(this, "cart has " + cart.Count() + " items, must be between 1 and " + MAX_CART_ITEMS);
+				return;
+			}
+
+			auto rpc = Expansion_CreateRPC("RPC_RequestPurchaseCart");
+			rpc.Write(cart.Count());
+			foreach (ExpansionMarketCartItem line: cart)
+			{
+				line.OnSend(rpc);
+			}
+			rpc.Expansion_Send(trader.GetTraderEntity(), true);
+		}
+	}
+
+	// ------------------------------------------------------------
+	// Expansion RPC_RequestPurchaseCart
+	// Server only
+	// ------------------------------------------------------------
+	private void RPC_RequestPurchaseCart(PlayerIdentity senderRPC, Object target, ParamsReadContext ctx)
+	{
+#ifdef EXTRACE
+		auto trace = EXTrace.Start(EXTrace.MARKET, this);
+#endif
+
+		if (!GetExpansionSettings().GetMarket().MarketSystemEnabled)
+			return;
+
+		int count;
+		if (!ctx.Read(count) || count < 1 || count > MAX_CART_ITEMS)
+			return;
+
+		array<ref ExpansionMarketCartItem> cart = {};
+		for (int i = 0; i < count; i++)
+		{
+			ExpansionMarketCartItem line = new ExpansionMarketCartItem();
+			if (!line.OnRecieve(ctx))
+				return;
+
+			cart.Insert(line);
+		}
+
+		ExpansionTraderObjectBase trader = GetTraderFromObject(target);
+		if (!trader)
+			return;
+
+		PlayerBase player = PlayerBase.GetPlayerByUID(senderRPC.GetId());
+		if (!player)
+			return;
+
+		if (!CheckCanUseTrader(player, trader))
+			return;
+
+		Exec_RequestPurchaseCart(player, trader, cart);
+	}
+
 	static ExpansionTraderObjectBase GetTraderFromObject(Object obj, bool errorOnNoTrader = true)
 	{
 #ifdef EXTRACE
@@ -2757,8 +2964,7 @@ class ExpansionMarketModule: CF_ModuleWorld
 		reservedList.Debug();
 		#endif
 
-		// !TODO: Finish method RemoveReservedStock in PlayerBase
-		GetGame().GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(RemoveReservedStock, 30000, false, player, itemClassName);
+		reservedList.Token = m_ReservationScheduler.Schedule(player, itemClassName, reservedList.Time);
 
 		Exec_ConfirmPurchase(player, itemClassName, includeAttachments, skinIndex);
 	}
@@ -2856,34 +3062,7 @@ class ExpansionMarketModule: CF_ModuleWorld
 		
 		if (objs.Count())
 		{
-			TStringArray itemIDs = {};
-			itemIDs.Reserve(objs.Count());
-			
-			foreach (ExpansionMarketReserveItem currentReservedItem: reserve.Reserved)
-			{
-				int spawnedAmount = spawnedAmounts[currentReservedItem.ClassName];
-				if (spawnedAmount < currentReservedItem.Amount)
-				{
-					if (spawnedAmount)
-						zone.RemoveStock(currentReservedItem.ClassName, spawnedAmount, false);
-					spawnedAmounts.Remove(currentReservedItem.ClassName);
-					reserve.Price -= currentReservedItem.Price / currentReservedItem.Amount * (currentReservedItem.Amount - spawnedAmount);
-				}
-				else
-				{
-					zone.RemoveStock(currentReservedItem.ClassName, currentReservedItem.Amount, false);
-					spawnedAmounts[currentReservedItem.ClassName] = spawnedAmount - currentReservedItem.Amount;
-				}
-
-				string itemID;
-				if (currentReservedItem.ClassName == itemClassName)
-					itemID = ExpansionStatic.GetInstanceID(currentReservedItem.CreatedObj);
-				else if (!currentReservedItem.CreatedObj)  //! Ammo in mags/ammopiles are not entities
-					itemID = string.Format("%1 x%2", currentReservedItem.ClassName, currentReservedItem.Amount);
-				else
-					itemID = currentReservedItem.CreatedObj.ToString();
-				itemIDs.Insert(itemID);
-			}
+			TStringArray itemIDs = CommitReservedStock(reserve, zone, spawnedAmounts, itemClassName);
 
 			int removed = RemoveMoney(player, reserve.Price);
 
@@ -2902,6 +3081,8 @@ class ExpansionMarketModule: CF_ModuleWorld
 			ExpansionLogMarket(string.Format("Player \"%1\" (id=%2) has bought %3 %4 from the trader \"%5 (%6)\" in market zone \"%7\" (pos=%8) for a price of %9.", player.GetIdentity().GetName(), player.GetIdentity().GetId(), reserve.RootItem.ClassName, itemsDetail, reserve.Trader.GetTraderMarket().m_FileName, reserve.Trader.GetDisplayName(), reserve.Trader.GetTraderZone().m_DisplayName, reserve.Trader.GetTraderZone().Position.ToString(), reserve.Price));	
 			
 			Callback(itemClassName, ExpansionMarketResult.PurchaseSuccess, player.GetIdentity(), reserve.TotalAmount, reserve.Price);
+
+			m_ReservationScheduler.Cancel(reserve.Token, true);
 		}
 		else
 		{
@@ -2915,6 +3096,278 @@ class ExpansionMarketModule: CF_ModuleWorld
 			zone.Save();
 	}
 
+	//! Removes stock for everything that was actually spawned and adjusts reserve price for anything that wasn't.
+	//! Returns IDs of the spawned items for logging.
+	protected TStringArray CommitReservedStock(ExpansionMarketReserve reserve, ExpansionMarketTraderZone zone, TStringIntMap spawnedAmounts, string itemClassName)
+	{
+		TStringArray itemIDs = {};
+		itemIDs.Reserve(reserve.Reserved.Count());
+
+		foreach (ExpansionMarketReserveItem currentReservedItem: reserve.Reserved)
+		{
+			int spawnedAmount = spawnedAmounts[currentReservedItem.ClassName];
+			if (spawnedAmount < currentReservedItem.Amount)
+			{
+				if (spawnedAmount)
+					zone.RemoveStock(currentReservedItem.ClassName, spawnedAmount, false);
+				spawnedAmounts.Remove(currentReservedItem.ClassName);
+				reserve.Price -= currentReservedItem.Price / currentReservedItem.Amount * (currentReservedItem.Amount - spawnedAmount);
+			}
+			else
+			{
+				zone.RemoveStock(currentReservedItem.ClassName, currentReservedItem.Amount, false);
+				spawnedAmounts[currentReservedItem.ClassName] = spawnedAmount - currentReservedItem.Amount;
+			}
+
+			string itemID;
+			if (currentReservedItem.ClassName == itemClassName)
+				itemID = ExpansionStatic.GetInstanceID(currentReservedItem.CreatedObj);
+			else if (!currentReservedItem.CreatedObj)  //! Ammo in mags/ammopiles are not entities
+				itemID = string.Format("%1 x%2", currentReservedItem.ClassName, currentReservedItem.Amount);
+			else
+				itemID = currentReservedItem.CreatedObj.ToString();
+			itemIDs.Insert(itemID);
+		}
+
+		return itemIDs;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion Exec_RequestPurchaseCart
+	// ------------------------------------------------------------
+	//! Server only
+	//! Buys all cart lines in one transaction: stock for every line is reserved up front (all or nothing),
+	//! money is found and removed once for the combined price, change is spawned once and the zone is saved once.
+	private void Exec_RequestPurchaseCart(notnull PlayerBase player, ExpansionTraderObjectBase trader, array<ref ExpansionMarketCartItem> cart)
+	{
+#ifdef EXTRACE
+		auto trace = EXTrace.Start(EXTrace.MARKET, this);
+#endif
+
+		ExpansionMarketTraderZone zone = trader.GetTraderZone();
+		if (!zone)
+		{
+			CartCallback(ExpansionMarketResult.FailedUnknown, player.GetIdentity());
+			return;
+		}
+
+		ExpansionMarketResult result = ExpansionMarketResult.Success;
+		string failedClassName;
+		int totalPrice;
+
+		foreach (ExpansionMarketCartItem line: cart)
+		{
+			result = ReserveCartItem(player, trader, line, failedClassName);
+			if (result != ExpansionMarketResult.Success)
+				break;
+
+			totalPrice += line.Reserve.Price;
+			if (totalPrice < 0)
+			{
+				failedClassName = line.Reserve.RootItem.ClassName;
+				result = ExpansionMarketResult.IntegerOverflow;
+				break;
+			}
+		}
+
+		if (result == ExpansionMarketResult.Success && vector.Distance(player.GetPosition(), trader.GetTraderEntity().GetPosition()) > MAX_TRADER_INTERACTION_DISTANCE)
+			result = ExpansionMarketResult.FailedTooFarAway;
+
+		if (result == ExpansionMarketResult.Success)
+		{
+			UnlockMoney(player);
+
+			array<int> monies;
+			if (!FindMoneyAndCountTypes(player, totalPrice, monies, true, NULL, trader.GetTraderMarket()))
+			{
+				UnlockMoney(player);
+				result = ExpansionMarketResult.FailedNotEnoughMoney;
+			}
+		}
+
+		if (result != ExpansionMarketResult.Success)
+		{
+			foreach (ExpansionMarketCartItem reservedLine: cart)
+			{
+				if (reservedLine.Reserve)
+					reservedLine.Reserve.ClearReserved(zone);
+			}
+
+			MarketModulePrint("Exec_RequestPurchaseCart - Callback " + typename.EnumToString(ExpansionMarketResult, result) + " " + failedClassName);
+
+			CartCallback(result, player.GetIdentity(), failedClassName);
+			return;
+		}
+
+		EntityAI parent = player;
+		bool attachmentNotAttached;
+		TStringArray boughtClassNames = {};
+		TIntArray boughtAmounts = {};
+
+		totalPrice = 0;
+
+		foreach (ExpansionMarketCartItem boughtLine: cart)
+		{
+			ExpansionMarketReserve reserve = boughtLine.Reserve;
+			string itemClassName = reserve.RootItem.ClassName;
+
+			TStringIntMap spawnedAmounts = new TStringIntMap;
+			array<Object> objs = Spawn(reserve, player, parent, boughtLine.IncludeAttachments, boughtLine.SkinIndex, attachmentNotAttached, spawnedAmounts);
+
+			if (objs.Count())
+			{
+				TStringArray itemIDs = CommitReservedStock(reserve, zone, spawnedAmounts, itemClassName);
+
+				totalPrice += reserve.Price;
+				boughtClassNames.Insert(itemClassName);
+				boughtAmounts.Insert(reserve.TotalAmount);
+
+				string itemsDetail = string.Format("x%1 (%2)", reserve.TotalAmount, ExpansionString.JoinStrings(itemIDs, ", ", true));
+
+				ExpansionLogMarket(string.Format("Player \"%1\" (id=%2) has bought %3 %4 from the trader \"%5 (%6)\" in market zone \"%7\" (pos=%8) for a price of %9.", player.GetIdentity().GetName(), player.GetIdentity().GetId(), itemClassName, itemsDetail, trader.GetTraderMarket().m_FileName, trader.GetDisplayName(), zone.m_DisplayName, zone.Position.ToString(), reserve.Price));
+			}
+			else
+			{
+				Error("Exec_RequestPurchaseCart - Couldn't spawn " + itemClassName);
+			}
+
+			reserve.ClearReserved(zone);
+		}
+
+		//! Also unlocks all reserved money if nothing could be spawned
+		int removed = RemoveMoney(player, totalPrice);
+
+		MarketModulePrint("Exec_RequestPurchaseCart - " + boughtClassNames.Count() + "/" + cart.Count() + " lines bought, total money removed: " + removed + ", change owed to player: " + (removed - totalPrice));
+
+		if (removed - totalPrice > 0)
+			SpawnMoney(player, parent, removed - totalPrice, true, NULL, trader.GetTraderMarket());
+
+		CheckSpawn(player, parent, attachmentNotAttached);
+
+		if (boughtClassNames.Count())
+		{
+			zone.Save();
+
+			CartCallback(ExpansionMarketResult.PurchaseSuccess, player.GetIdentity(), string.Empty, boughtClassNames, boughtAmounts, totalPrice);
+		}
+		else
+		{
+			CartCallback(ExpansionMarketResult.FailedItemSpawn, player.GetIdentity());
+		}
+	}
+
+	//! Server only. Validates a single cart line and reserves its stock in line.Reserve
+	protected ExpansionMarketResult ReserveCartItem(PlayerBase player, ExpansionTraderObjectBase trader, ExpansionMarketCartItem line, out string itemClassName)
+	{
+		ExpansionMarketItem item = ExpansionMarketCategory.GetGlobalItem(line.ItemID);
+		if (!item)
+		{
+			itemClassName = string.Format("UNKNOWN_ITEM_ID_%1", line.ItemID);
+			return ExpansionMarketResult.FailedItemDoesNotExistInTrader;
+		}
+
+		itemClassName = item.ClassName;
+
+		if (line.Count <= 0)
+			return ExpansionMarketResult.FailedNoCount;
+
+		//! Vehicles need free spawn positions and exchange items special money handling, those can only be bought one by one
+		if (item.IsVehicle() || GetItemCategory(item).IsExchange)
+			return ExpansionMarketResult.FailedCannotBuy;
+
+	#ifdef EXPANSIONMODHARDLINE
+		if (GetExpansionSettings().GetHardline().UseReputation && GetExpansionSettings().GetHardline().UseItemRarityForMarketPurchase)
+		{
+			ExpansionHardlineItemRarity rarity = GetExpansionSettings().GetHardline().GetItemRarityByType(itemClassName);
+			if (rarity && !HasRepForRarityEx(player, rarity))
+				return ExpansionMarketResult.FailedCannotBuy;
+		}
+	#endif
+
+		if (line.AttachmentIDs && line.AttachmentIDs.Count())
+		{
+			ExpansionMarketItem derivative = new ExpansionMarketItem(item.CategoryID, itemClassName, item.MinPriceThreshold, item.MaxPriceThreshold, item.MinStockThreshold, item.MaxStockThreshold, NULL, item.Variants, item.SellPricePercent, item.QuantityPercent, item.ItemID, line.AttachmentIDs);
+			derivative.SetAttachmentsFromIDs();
+			item = derivative;
+		}
+
+		line.Reserve = new ExpansionMarketReserve;
+		line.Reserve.Trader = trader;
+
+		ExpansionMarketResult result;
+		if (!FindPurchasePriceAndReserve(item, line.Count, line.Reserve, line.IncludeAttachments, result))
+		{
+			if (result == ExpansionMarketResult.Success)
+				result = ExpansionMarketResult.FailedUnknown;
+
+			return result;
+		}
+
+		if (line.Reserve.Price != line.Price)
+		{
+			//! Same tolerance as single item purchase, see Exec_RequestPurchase
+			if (Math.AbsInt(line.Reserve.Price - line.Price) != 1)
+				return ExpansionMarketResult.FailedStockChange;
+
+			if (line.Reserve.Price < line.Price)
+				line.Reserve.Price = line.Price;
+		}
+
+		return ExpansionMarketResult.Success;
+	}
+
+	//! Server only
+	void CartCallback(ExpansionMarketResult result, PlayerIdentity playerIdent, string failedClassName = string.Empty, TStringArray classNames = NULL, TIntArray amounts = NULL, int price = 0)
+	{
+		if (!classNames)
+			classNames = {};
+
+		if (!amounts)
+			amounts = {};
+
+		auto rpc = Expansion_CreateRPC("RPC_CartCallback");
+		rpc.Write(result);
+		rpc.Write(failedClassName);
+		rpc.Write(classNames);
+		rpc.Write(amounts);
+		rpc.Write(price);
+		rpc.Expansion_Send(true, playerIdent);
+	}
+
+	// ------------------------------------------------------------
+	// Expansion RPC_CartCallback
+	// ------------------------------------------------------------
+	private void RPC_CartCallback(PlayerIdentity senderRPC, Object target, ParamsReadContext ctx)
+	{
+#ifdef EXTRACE
+		auto trace = EXTrace.Start(EXTrace.MARKET, this);
+#endif
+
+		int result;
+		if (!ctx.Read(result))
+			return;
+
+		string failedClassName;
+		if (!ctx.Read(failedClassName))
+			return;
+
+		TStringArray classNames;
+		if (!ctx.Read(classNames))
+			return;
+
+		TIntArray amounts;
+		if (!ctx.Read(amounts))
+			return;
+
+		int price;
+		if (!ctx.Read(price))
+			return;
+
+		MarketModulePrint("RPC_CartCallback - result: " + result + " lines: " + classNames.Count() + " price: " + price);
+
+		SI_CartCallback.Invoke(result, failedClassName, classNames, amounts, price);
+	}
+
 	void ClearReserved(PlayerBase player, bool unlockMoney = false)
 	{
 		if (unlockMoney)
@@ -2923,6 +3376,8 @@ class ExpansionMarketModule: CF_ModuleWorld
 		ExpansionMarketReserve reserve = player.GetMarketReserve();
 		ExpansionMarketTraderZone zone = reserve.Trader.GetTraderZone();
 
+		m_ReservationScheduler.Cancel(reserve.Token);
+
 		reserve.ClearReserved(zone);
 		player.ClearMarketReserve();
 	}
@@ -3546,12 +4001,14 @@ class ExpansionMarketModule: CF_ModuleWorld
 		auto rpc = Expansion_CreateRPC("RPC_LoadTraderData");
 		rpc.Write(trader.GetTraderZone().BuyPricePercent);
 		rpc.Write(trader.GetTraderZone().SellPricePercent);
+		rpc.Write(trader.GetTraderZone().GetCatalogHash(trader.GetTraderMarket()));
 
 		rpc.Expansion_Send(trader.GetTraderEntity(), true, identity);
 	}
 	
 	//! Send trader items to client in batches
-	protected void LoadTraderItems(ExpansionTraderObjectBase trader, PlayerIdentity ident, int start = 0, bool stockOnly = false, TIntArray itemIDs = NULL)
+	//! @param protocol  Payload format requested by client, see ExpansionMarketNetworkItemCodec::PROTOCOL_VERSION
+	protected void LoadTraderItems(ExpansionTraderObjectBase trader, PlayerIdentity ident, int start = 0, bool stockOnly = false, TIntArray itemIDs = NULL, int protocol = 0)
 	{
 		MarketModulePrint("LoadTraderItems - Start - start: " + start + " stockOnly: " + stockOnly);
 
@@ -3613,10 +4070,22 @@ class ExpansionMarketModule: CF_ModuleWorld
 		else
 			rpc.Write(trader.GetTraderMarket().m_Items.Count());
 		rpc.Write(stockOnly);
-		rpc.Write(networkBaseItems);
-		rpc.Write(networkItems);
+		if (protocol > 0)
+		{
+			rpc.Write(ExpansionMarketNetworkItemCodec.PROTOCOL_VERSION);
+			ExpansionMarketNetworkItemCodec.Write(rpc, networkBaseItems, networkItems);
+		}
+		else
+		{
+			rpc.Write(networkBaseItems);
+			rpc.Write(networkItems);
+		}
 		rpc.Expansion_Send(trader.GetTraderEntity(), true, ident);
 
+	#ifdef EXPANSIONMODMARKET_DEBUG
+		MarketModulePrint("LoadTraderItems - protocol " + protocol + " - " + ExpansionMarketNetworkItemCodec.GetSizeComparison(networkBaseItems, networkItems));
+	#endif
+
 		MarketModulePrint("LoadTraderItems - End - start: " + start + " end: " + next);
 	}
 	
@@ -3652,6 +4121,13 @@ class ExpansionMarketModule: CF_ModuleWorld
 			return;
 		}
 
+		int catalogHash;
+		if (!ctx.Read(catalogHash))
+		{
+			Error("ExpansionMarketModule::RPC_LoadTraderData - Could not read catalog hash!");
+			return;
+		}
+
 		EXTrace.Print(EXTrace.MARKET, this, "Setting client trader: " + trader);
 		m_OpenedClientTrader = trader;
 		m_TraderEntity = trader.GetTraderEntity();
@@ -3661,9 +4137,37 @@ class ExpansionMarketModule: CF_ModuleWorld
 			return;
 
 		bool stockOnly = trader.GetTraderMarket().m_StockOnly;  //! If already netsynched, request stock only
+		m_ClientCatalogHash = 0;
+		if (!stockOnly && catalogHash)
+		{
+			//! If items are cached from a previous session, request stock only, else cache items once received
+			if (LoadTraderCatalog_Client(trader, catalogHash))
+				stockOnly = true;
+			else
+				m_ClientCatalogHash = catalogHash;
+		}
+
 		RequestTraderItems(trader, 0, stockOnly);
 	}
 
+	//! Adds items of `trader` from client catalog cache if it matches `catalogHash`
+	protected bool LoadTraderCatalog_Client(ExpansionTraderObjectBase trader, int catalogHash)
+	{
+		int start = TickCount(0);
+
+		array<ref ExpansionMarketNetworkBaseItem> networkBaseItems = new array<ref ExpansionMarketNetworkBaseItem>;
+		array<ref ExpansionMarketNetworkItem> networkItems = new array<ref ExpansionMarketNetworkItem>;
+		if (!ExpansionMarketClientCatalogCache.Load(trader.GetTraderMarket().m_FileName, catalogHash, networkBaseItems, networkItems))
+			return false;
+
+		ClearTmpNetworkCaches();
+		AddTraderItems_Client(trader, networkBaseItems, networkItems, true);
+
+		EXPrint(ToString() + "::LoadTraderCatalog_Client - Added " + networkItems.Count() + " items and " + networkBaseItems.Count() + " stock only items of " + trader.GetTraderMarket().m_FileName + " from catalog cache in " + (TickCount(start) / 10000.0) + " ms, requesting stock only");
+
+		return true;
+	}
+
 	// ------------------------------------------------------------
 	// Expansion RequestTraderItems - client
 	// ------------------------------------------------------------
@@ -3679,10 +4183,15 @@ class ExpansionMarketModule: CF_ModuleWorld
 			return;
 		}
 		
+		//! Only cache items of complete trader
+		if (itemIDs && itemIDs.Count())
+			m_ClientCatalogHash = 0;
+
 		auto rpc = Expansion_CreateRPC("RPC_RequestTraderItems");
 		rpc.Write(start);
 		rpc.Write(stockOnly);
 		rpc.Write(itemIDs);
+		rpc.Write(ExpansionMarketNetworkItemCodec.PROTOCOL_VERSION);
 		rpc.Expansion_Send(trader.GetTraderEntity(), true);
 	}
 
@@ -3723,7 +4232,12 @@ class ExpansionMarketModule: CF_ModuleWorld
 			return;
 		}
 
-		LoadTraderItems(trader, senderRPC, start, stockOnly, itemIDs);
+		//! Not sent by clients predating the columnar item format
+		int protocol;
+		if (!ctx.Read(protocol))
+			protocol = 0;
+
+		LoadTraderItems(trader, senderRPC, start, stockOnly, itemIDs, protocol);
 	}
 
 	// ------------------------------------------------------------
@@ -3784,18 +4298,26 @@ class ExpansionMarketModule: CF_ModuleWorld
 
 		auto hitch = new EXHitch(ToString() + "::RPC_LoadTraderItems - update market items ");
 	
-		array<ref ExpansionMarketNetworkBaseItem> networkBaseItems = new array<ref ExpansionMarketNetworkBaseItem>;
-		if (!ctx.Read(networkBaseItems))
+		int protocol;
+		if (!ctx.Read(protocol))
+		{
+			Error("ExpansionMarketModule::RPC_LoadTraderItems - Could not read protocol version!");
+			SI_SetTraderInvoker.Invoke(trader, true);
+			return;
+		}
+
+		if (protocol != ExpansionMarketNetworkItemCodec.PROTOCOL_VERSION)
 		{
-			Error("ExpansionMarketModule::RPC_LoadTraderItems - Could not read networkBaseItems array!");
+			Error("ExpansionMarketModule::RPC_LoadTraderItems - Unsupported protocol version " + protocol + "!");
 			SI_SetTraderInvoker.Invoke(trader, true);
 			return;
 		}
 
+		array<ref ExpansionMarketNetworkBaseItem> networkBaseItems = new array<ref ExpansionMarketNetworkBaseItem>;
 		array<ref ExpansionMarketNetworkItem> networkItems = new array<ref ExpansionMarketNetworkItem>;
-		if (!ctx.Read(networkItems))
+		if (!ExpansionMarketNetworkItemCodec.Read(ctx, networkBaseItems, networkItems))
 		{
-			Error("ExpansionMarketModule::RPC_LoadTraderItems - Could not read networkItems array!");
+			Error("ExpansionMarketModule::RPC_LoadTraderItems - Could not read network items!");
 			SI_SetTraderInvoker.Invoke(trader, true);
 			return;
 		}
@@ -3807,15 +4329,62 @@ class ExpansionMarketModule: CF_ModuleWorld
 			return;
 		}
 
-		int i;
-		ExpansionMarketItem item;
-
 		if (start == 0)
 		{
 			//! 1st batch, make sure cache is clear
 			ClearTmpNetworkCaches();
+			m_ClientCatalogBaseItems.Clear();
+			m_ClientCatalogItems.Clear();
 		}
 
+		if (!stockOnly && m_ClientCatalogHash)
+		{
+			foreach (ExpansionMarketNetworkBaseItem catalogBaseItem : networkBaseItems)
+			{
+				m_ClientCatalogBaseItems.Insert(catalogBaseItem);
+			}
+
+			foreach (ExpansionMarketNetworkItem catalogItem : networkItems)
+			{
+				m_ClientCatalogItems.Insert(catalogItem);
+			}
+		}
+
+		bool isLastBatch = count - next == 0;
+
+		AddTraderItems_Client(trader, networkBaseItems, networkItems, isLastBatch);
+
+		delete hitch;
+
+		if (isLastBatch)
+		{
+			if (!stockOnly && m_ClientCatalogHash)
+			{
+				ExpansionMarketClientCatalogCache.Save(trader.GetTraderMarket().m_FileName, m_ClientCatalogHash, m_ClientCatalogBaseItems, m_ClientCatalogItems);
+				m_ClientCatalogHash = 0;
+			}
+
+			m_ClientCatalogBaseItems.Clear();
+			m_ClientCatalogItems.Clear();
+
+			SI_SetTraderInvoker.Invoke(trader, true);
+		}
+		else
+		{
+			//! Client can draw received items so far
+			SI_SetTraderInvoker.Invoke(trader, false);
+
+			//! Request next batch
+			RequestTraderItems(trader, next, stockOnly);
+		}
+	}
+
+	//! Client. Adds received (or cached) items to trader and sets stock, finalizes categories and trader once `isLastBatch`
+	protected void AddTraderItems_Client(ExpansionTraderObjectBase trader, array<ref ExpansionMarketNetworkBaseItem> networkBaseItems, array<ref ExpansionMarketNetworkItem> networkItems, bool isLastBatch)
+	{
+		int i;
+		ExpansionMarketItem item;
+
 		if (networkItems.Count())
 		{
 			//! Add full items + set stock
@@ -3861,10 +4430,8 @@ class ExpansionMarketModule: CF_ModuleWorld
 		{
 			m_TmpNetworkBaseItems.Insert(networkBaseItems[i]);
 		}
-		
-		delete hitch;
 
-		if (count - next == 0)
+		if (isLastBatch)
 		{
 			//! Last batch
 
@@ -3909,15 +4476,6 @@ class ExpansionMarketModule: CF_ModuleWorld
 			ClearTmpNetworkCaches();
 
 			trader.GetTraderMarket().m_StockOnly = true;
-			SI_SetTraderInvoker.Invoke(trader, true);
-		}
-		else
-		{
-			//! Client can draw received items so far
-			SI_SetTraderInvoker.Invoke(trader, false);
-
-			//! Request next batch
-			RequestTraderItems(trader, next, stockOnly);
 		}
 	}
 
@@ -3948,9 +4506,7 @@ class ExpansionMarketModule: CF_ModuleWorld
 
 	bool IsMoney(EntityAI item)
 	{
-		string type = item.GetType();
-		type.ToLower();
-		return IsMoney(type);
+		return IsMoney(ExpansionMarketClassName.Normalize(item.GetType()));
 	}
 
 	// -----------------------------------------------------------
@@ -3979,7 +4535,6 @@ class ExpansionMarketModule: CF_ModuleWorld
 		MarketModulePrint("GetAmountInInventory - Start");
 		
 		string itemName = item.ClassName;
-		itemName.ToLower();
 		
 		int sellable;
 		int unsellable;
@@ -3989,10 +4544,7 @@ class ExpansionMarketModule: CF_ModuleWorld
 			if (entity == NULL)
 				continue;
 
-			string entName = entity.GetType();
-			entName.ToLower();
-			
-			entName = GetMarketItemClassName(m_OpenedClientTrader.GetTraderMarket(), entName);
+			string entName = GetMarketItemClassName(m_OpenedClientTrader.GetTraderMarket(), ExpansionMarketClassName.Normalize(entity.GetType()));
 
 			if (entName != itemName)
 				continue;
@@ -4027,19 +4579,15 @@ class ExpansionMarketModule: CF_ModuleWorld
 		array<EntityAI> itemsArray = new array<EntityAI>;
 		int totalAmount = 0;
 
+		int itemNameID = ExpansionMarketClassName.GetID(item.ClassName);
+
 		for (int i = 0; i < entitys.Count(); i++)
 		{
 			EntityAI entity = entitys.Get(i);
 			if (entity == NULL)
 				continue;
 
-			string entName = entity.GetType();
-			entName.ToLower();
-			
-			string itemName = item.ClassName;
-			itemName.ToLower();
-			
-			if (entName != itemName)
+			if (ExpansionMarketClassName.GetID(entity.GetType()) != itemNameID)
 				continue;
 			
 			itemsArray.Insert(entity);
@@ -0,0 +1,166 @@
+/**
+ * ExpansionMarketParkingFineEngine.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2024 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+class ExpansionMarketParkingFineEntry: ExpansionMarketDeadlineEntry
+{
+	ExpansionVehicle Vehicle;
+
+	void ExpansionMarketParkingFineEntry(ExpansionVehicle vehicle)
+	{
+		Vehicle = vehicle;
+	}
+}
+
+//! Server only. Keeps vehicles parked in safezones ordered by the time their max parking time runs out,
+//! so only vehicles whose deadline has passed get evaluated instead of every vehicle on every CE update.
+class ExpansionMarketParkingFineEngine
+{
+	//! Deadlines only drift by CE update jitter while a vehicle stays parked, don't re-key entries for changes below this (ms)
+	static const int DEADLINE_TOLERANCE = 1000;
+
+	protected static ref ExpansionMarketParkingFineEngine s_Instance;
+
+	protected ref ExpansionMarketDeadlineQueue m_Queue;
+
+	protected int m_LastTickEvaluated;
+	protected int m_LastTickFined;
+	protected float m_LastTickTime;
+
+	void ExpansionMarketParkingFineEngine()
+	{
+		m_Queue = new ExpansionMarketDeadlineQueue;
+	}
+
+	static ExpansionMarketParkingFineEngine GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new ExpansionMarketParkingFineEngine;
+
+		return s_Instance;
+	}
+
+	//! Insert, reschedule or drop vehicle depending on its current safezone parking state
+	void Track(ExpansionVehicle vehicle)
+	{
+		ExpansionMarketParkingFineEntry entry = vehicle.Expansion_GetParkingFineEntry();
+
+		if (!vehicle.IsParkingFineCandidate())
+		{
+			m_Queue.Remove(entry);
+			return;
+		}
+
+		int deadline = GetGame().GetTime() + vehicle.GetParkingFineDelay();
+		if (entry.IsQueued() && Math.AbsInt(deadline - entry.Deadline) < DEADLINE_TOLERANCE)
+			return;
+
+		m_Queue.Update(entry, deadline);
+	}
+
+	//! Drop vehicle from the queue, e.g. when it is deleted
+	void Untrack(ExpansionVehicle vehicle)
+	{
+		ExpansionMarketParkingFineEntry entry = vehicle.Expansion_GetParkingFineEntry(false);
+		if (entry)
+			m_Queue.Remove(entry);
+	}
+
+	//! Evaluate all vehicles whose deadline is at or before `time`, returns number of evaluated vehicles
+	int Tick(int time)
+	{
+		int start = TickCount(0);
+		int evaluated;
+		int fined;
+
+		ExpansionMarketParkingFineEntry entry;
+		while (Class.CastTo(entry, m_Queue.PopExpired(time)))
+		{
+			ExpansionVehicle vehicle = entry.Vehicle;
+			if (!vehicle || !vehicle.GetEntity())
+				continue;
+
+			vehicle.EvaluateSafeZoneParkingFine();
+			evaluated++;
+
+			if (vehicle.GetParkingFine() > 0)
+				fined++;
+			else if (vehicle.IsParkingFineCandidate())
+				m_Queue.Update(entry, time + Math.Max(vehicle.GetParkingFineDelay(), 1000));
+		}
+
+		if (evaluated)
+		{
+			m_LastTickEvaluated = evaluated;
+			m_LastTickFined = fined;
+			m_LastTickTime = TickCount(start) / 10000.0;
+
+		#ifdef EXPANSIONMODMARKET_DEBUG
+			EXPrint(ToString() + "::Tick - " + GetMetrics());
+		#endif
+		}
+
+		return evaluated;
+	}
+
+	//! Pay parking fines of all given vehicles in a single money transaction. Returns false if player can't afford the total.
+	bool PayParkingFines(PlayerBase player, array<ExpansionVehicle> vehicles)
+	{
+		int amount;
+		foreach (ExpansionVehicle vehicle: vehicles)
+		{
+			amount += vehicle.GetParkingFine();
+		}
+
+		if (amount <= 0)
+			return false;
+
+		ExpansionMarketModule market = ExpansionMarketModule.GetInstance();
+
+		TIntArray monies = {};
+		if (!market.FindMoneyAndCountTypes(player, amount, monies, true))
+		{
+			market.UnlockMoney(player);
+			return false;
+		}
+
+		int removed = market.RemoveMoney(player);
+		if (removed - amount > 0)
+		{
+			EntityAI parent = player;
+			market.SpawnMoney(player, parent, removed - amount, true);
+			market.CheckSpawn(player, parent);
+		}
+
+		foreach (ExpansionVehicle paid: vehicles)
+		{
+			if (!paid.GetParkingFine())
+				continue;
+
+			paid.ForceUnlock(ExpansionVehicleLockState.UNLOCKED);
+			paid.SetParkingFine(0);
+			paid.ResetSZParkingTime();
+			Untrack(paid);
+		}
+
+		return true;
+	}
+
+	int GetTrackedCount()
+	{
+		return m_Queue.Count();
+	}
+
+	string GetMetrics()
+	{
+		return string.Format("tracked %1, evaluated %2, fined %3 in %4 ms", m_Queue.Count(), m_LastTickEvaluated, m_LastTickFined, m_LastTickTime);
+	}
+}
@@ -0,0 +1,120 @@
+/**
+ * ExpansionMarketReservationScheduler.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2024 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+class ExpansionMarketReservationEntry: ExpansionMarketDeadlineEntry
+{
+	int Token;
+	PlayerBase Player;
+	string ClassName;
+
+	void ExpansionMarketReservationEntry(int deadline, int token, PlayerBase player, string className)
+	{
+		Deadline = deadline;
+		Token = token;
+		Player = player;
+		ClassName = className;
+	}
+}
+
+//! Server only. Reservation deadlines in a min-heap, drained once per tick by ExpansionMarketModule
+//! instead of scheduling a CallLater closure per reservation.
+class ExpansionMarketReservationScheduler
+{
+	static const int RESERVATION_TIME = 30000;
+
+	protected ref ExpansionMarketDeadlineQueue m_Queue;
+	protected ref map<int, ExpansionMarketReservationEntry> m_Entries;
+	protected int m_NextToken;
+
+	protected int m_ExpiredCount;
+	protected int m_ConfirmedCount;
+	protected int m_CancelledCount;
+
+	void ExpansionMarketReservationScheduler()
+	{
+		m_Queue = new ExpansionMarketDeadlineQueue;
+		m_Entries = new map<int, ExpansionMarketReservationEntry>;
+	}
+
+	//! Returns reservation token (always > 0)
+	int Schedule(PlayerBase player, string className, int time)
+	{
+		int token = ++m_NextToken;
+
+		auto entry = new ExpansionMarketReservationEntry(time + RESERVATION_TIME, token, player, className);
+		m_Queue.Insert(entry);
+		m_Entries.Insert(token, entry);
+
+		return token;
+	}
+
+	//! Removes reservation with given token, returns false if it already expired or was cancelled before
+	bool Cancel(int token, bool confirmed = false)
+	{
+		ExpansionMarketReservationEntry entry;
+		if (!m_Entries.Find(token, entry))
+			return false;
+
+		m_Queue.Remove(entry);
+		m_Entries.Remove(token);
+
+		if (confirmed)
+			m_ConfirmedCount++;
+		else
+			m_CancelledCount++;
+
+		return true;
+	}
+
+	//! Moves all reservations with a deadline at or before `time` into `expired`, returns their count
+	int PopExpired(int time, array<ref ExpansionMarketReservationEntry> expired)
+	{
+		int count;
+
+		ExpansionMarketReservationEntry entry;
+		while (Class.CastTo(entry, m_Queue.PopExpired(time)))
+		{
+			m_Entries.Remove(entry.Token);
+			expired.Insert(entry);
+			count++;
+		}
+
+		m_ExpiredCount += count;
+
+		return count;
+	}
+
+	int GetOutstandingCount()
+	{
+		return m_Queue.Count();
+	}
+
+	int GetExpiredCount()
+	{
+		return m_ExpiredCount;
+	}
+
+	int GetConfirmedCount()
+	{
+		return m_ConfirmedCount;
+	}
+
+	int GetCancelledCount()
+	{
+		return m_CancelledCount;
+	}
+
+	string GetMetrics()
+	{
+		return string.Format("outstanding %1, expired %2, confirmed %3, cancelled %4", m_Queue.Count(), m_ExpiredCount, m_ConfirmedCount, m_CancelledCount);
+	}
+}
@@ -18,6 +18,9 @@ class ExpansionMarketReserve
 	ExpansionTraderObjectBase Trader;
 	int Time;
 
+	//! ExpansionMarketReservationScheduler token, 0 if not scheduled
+	int Token;
+
 	ref ExpansionMarketItem RootItem;
 
 	//! Total amount to buy (without modifiers and attachments)
@@ -62,6 +65,7 @@ class ExpansionMarketReserve
 	{
 		Price = 0;
 		TotalAmount = 0;
+		Token = 0;
 
 		if (zone)
 		{
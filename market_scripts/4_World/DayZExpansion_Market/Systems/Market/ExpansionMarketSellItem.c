@@ -68,8 +68,7 @@ class ExpansionMarketSell
 
 		if (!className && item)
 		{
-			className = item.GetType();
-			className.ToLower();
+			className = ExpansionMarketClassName.Normalize(item.GetType());
 		}
 		
 		ExpansionMarketSellItem itemSell = new ExpansionMarketSellItem;
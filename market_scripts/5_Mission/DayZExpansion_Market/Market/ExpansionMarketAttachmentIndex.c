@@ -0,0 +1,160 @@
+/**
+ * ExpansionMarketAttachmentIndex.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2024 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+//! Attachment compatibility index shared by all ExpansionMarketFilters instances.
+//! Config doesn't change during a game session, so the CfgVehicles/CfgMagazines walk only needs to happen once
+//! instead of every time the market menu is opened.
+class ExpansionMarketAttachmentIndex
+{
+	static const int MAX_HIERARCHY_DEPTH = 10;
+
+	//! Base name tokens that make a Clothing_Base descendant customizable in the market menu.
+	//! Bit N of an ancestor bitset is set if any class in the hierarchy contains token N.
+	static ref TStringArray s_CustomizableClothingTokens = {"vest", "chestrig", "bag", "backpack", "rucksack", "belt", "helmet", "headgear", "helm"};
+
+	protected static ref ExpansionMarketAttachmentIndex s_Instance;
+
+	//! slot (lowercase) -> classes that fit into it
+	protected ref map<string, ref TStringArray> m_SlotClasses;
+
+	//! weapon/clothing -> compatible magazines/bullets/attachments, filled lazily by ExpansionMarketFilters
+	protected ref ExpansionMarketOutputs m_Outputs;
+
+	//! class -> s_CustomizableClothingTokens ancestor bitset
+	protected ref map<string, int> m_ClothingAncestorBits;
+
+	void ExpansionMarketAttachmentIndex()
+	{
+		m_SlotClasses = new map<string, ref TStringArray>;
+		m_Outputs = new ExpansionMarketOutputs;
+		m_ClothingAncestorBits = new map<string, int>;
+	}
+
+	static ExpansionMarketAttachmentIndex GetInstance()
+	{
+		if (!s_Instance)
+		{
+			s_Instance = new ExpansionMarketAttachmentIndex();
+			s_Instance.Build();
+		}
+
+		return s_Instance;
+	}
+
+	protected void Build()
+	{
+		int start = TickCount(0);
+
+		BuildSlotClassesFromPath("CfgVehicles");
+		BuildSlotClassesFromPath("CfgMagazines");
+
+		EXPrint(ToString() + "::Build - indexed " + m_SlotClasses.Count() + " attachment slots in " + (TickCount(start) / 10000.0) + " ms");
+	}
+
+	protected void BuildSlotClassesFromPath(string path)
+	{
+		int count = GetGame().ConfigGetChildrenCount(path);
+
+		for (int i = 0; i < count; i++)
+		{
+			string itemName;
+			GetGame().ConfigGetChildName(path, i, itemName);
+
+			string slotPath = path + " " + itemName + " inventorySlot";
+			switch (GetGame().ConfigGetType(slotPath))
+			{
+				case CT_ARRAY:
+				{
+					TStringArray inventorySlots = {};
+					GetGame().ConfigGetTextArray(slotPath, inventorySlots);
+					foreach (string inventorySlot: inventorySlots)
+					{
+						AddSlotClass(inventorySlot, itemName);
+					}
+					break;
+				}
+				case CT_STRING:
+				{
+					string slot;
+					GetGame().ConfigGetText(slotPath, slot);
+					AddSlotClass(slot, itemName);
+					break;
+				}
+			}
+		}
+	}
+
+	protected void AddSlotClass(string slot, string className)
+	{
+		slot.ToLower();
+
+		TStringArray classNames = m_SlotClasses[slot];
+		if (!classNames)
+		{
+			classNames = new TStringArray;
+			m_SlotClasses.Insert(slot, classNames);
+		}
+
+		classNames.Insert(className);
+	}
+
+	map<string, ref TStringArray> GetSlotClasses()
+	{
+		return m_SlotClasses;
+	}
+
+	ExpansionMarketOutputs GetOutputs()
+	{
+		return m_Outputs;
+	}
+
+	int GetClothingAncestorBits(string className)
+	{
+		int bits;
+		if (m_ClothingAncestorBits.Find(className, bits))
+			return bits;
+
+		bits = ComputeAncestorBits(className, "CfgVehicles", s_CustomizableClothingTokens, "Clothing_Base");
+		m_ClothingAncestorBits.Insert(className, bits);
+
+		return bits;
+	}
+
+	//! Same traversal as ExpansionMarketFilters::ClassNameHierarchyContains, but records every matching token instead of returning on the first one
+	static int ComputeAncestorBits(string className, string cfgPath, TStringArray tokens, string stopAt = "Inventory_Base")
+	{
+		int bits;
+		string baseName = className;
+		string baseNameLower;
+
+		for (int i = 0; i < MAX_HIERARCHY_DEPTH; i++)
+		{
+			baseNameLower = baseName;
+			baseNameLower.ToLower();
+
+			foreach (int j, string token: tokens)
+			{
+				if (baseNameLower.Contains(token))
+					bits |= 1 << j;
+			}
+
+			GetGame().ConfigGetBaseName(cfgPath + " " + className, baseName);
+
+			if (baseName == "All" || baseName == stopAt)
+				break;
+
+			className = baseName;
+		}
+
+		return bits;
+	}
+};
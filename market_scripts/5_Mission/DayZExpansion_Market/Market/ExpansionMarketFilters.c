@@ -38,21 +38,31 @@ class ExpansionMarketFilters
 	protected ref ExpansionMarketModule m_MarketModule;
 	protected ref ExpansionMarketMenu m_Menu;
 
+#ifdef EXPANSIONMODMARKET_DEBUG
+	protected static bool s_AttachmentsMapParityChecked;
+#endif
+
 	void ExpansionMarketFilters()
 	{
 		if (!m_MarketModule)
 			m_MarketModule = ExpansionMarketModule.Cast(CF_ModuleCoreManager.Get(ExpansionMarketModule));
 
+		//! Slot map and weapon/clothing outputs only depend on config, so they are shared across menu instances
+		ExpansionMarketAttachmentIndex index = ExpansionMarketAttachmentIndex.GetInstance();
+
 		if (!m_AttachmentsMap)
-		{
-			m_AttachmentsMap = new map<string, ref TStringArray>;
-			GenerateAttachmentsMap();
-		}
+			m_AttachmentsMap = index.GetSlotClasses();
 		
 		if (!m_MarketOutputs)
+			m_MarketOutputs = index.GetOutputs();
+
+	#ifdef EXPANSIONMODMARKET_DEBUG
+		if (!s_AttachmentsMapParityChecked)
 		{
-			m_MarketOutputs = new ExpansionMarketOutputs;
+			s_AttachmentsMapParityChecked = true;
+			CheckAttachmentsMapParity();
 		}
+	#endif
 	}
 
 	//! Only added this because I didn't want to change signature of ExpansionMarketFilters constructor
@@ -178,15 +188,6 @@ class ExpansionMarketFilters
 		return items;
 	}
 
-	void GenerateAttachmentsMap()
-	{
-		if (m_AttachmentsMap)
-		{
-			GenerateAttachmentsMapFromPath(m_AttachmentsMap, "CfgVehicles");
-			GenerateAttachmentsMapFromPath(m_AttachmentsMap, "CfgMagazines");
-		}
-	}
-	
 	void GenerateAttachmentsMapFromPath(out map<string, ref TStringArray> currentMap, string path)
 	{
 		for (int i = 0; i < GetGame().ConfigGetChildrenCount(path); i++) 
@@ -260,10 +261,7 @@ class ExpansionMarketFilters
 					if (!item)
 						continue;
 
-					string type = item.GetType();
-					type.ToLower();
-			
-					type = m_MarketModule.GetMarketItemClassName(trader.GetTraderMarket(), type);
+					string type = m_MarketModule.GetMarketItemClassName(trader.GetTraderMarket(), ExpansionMarketClassName.Normalize(item.GetType()));
 
 					if (trader.GetTraderMarket().CanSellItem(type) && sellables.Find(type) == -1)
 						sellables.Insert(type);
@@ -396,8 +394,55 @@ class ExpansionMarketFilters
 	
 	static bool IsCustomizableClothing(string className)
 	{
-		return GetGame().IsKindOf(className, "Clothing_Base") && ClassNameHierarchyContains(className, "CfgVehicles", {"vest", "chestrig", "bag", "backpack", "rucksack", "belt", "helmet", "headgear", "helm"}, "Clothing_Base");
+		if (!GetGame().IsKindOf(className, "Clothing_Base"))
+			return false;
+
+	#ifdef EXPANSIONMODMARKET_DEBUG
+		CheckParity(className);
+	#endif
+
+		return ExpansionMarketAttachmentIndex.GetInstance().GetClothingAncestorBits(className) != 0;
+	}
+
+#ifdef EXPANSIONMODMARKET_DEBUG
+	//! Compares the indexed ancestor bitset against the uncached hierarchy walk it replaces
+	static bool CheckParity(string className)
+	{
+		bool indexed = ExpansionMarketAttachmentIndex.GetInstance().GetClothingAncestorBits(className) != 0;
+		bool walked = ClassNameHierarchyContains(className, "CfgVehicles", ExpansionMarketAttachmentIndex.s_CustomizableClothingTokens, "Clothing_Base");
+		if (indexed != walked)
+		{
+			EXPrint("ExpansionMarketFilters::CheckParity - " + className + " hierarchy mismatch (indexed " + indexed + ", walked " + walked + ")");
+			return false;
+		}
+
+		return true;
+	}
+
+	//! Compares the indexed slot map against a fresh CfgVehicles/CfgMagazines walk
+	bool CheckAttachmentsMapParity()
+	{
+		map<string, ref TStringArray> walkedMap = new map<string, ref TStringArray>;
+		GenerateAttachmentsMapFromPath(walkedMap, "CfgVehicles");
+		GenerateAttachmentsMapFromPath(walkedMap, "CfgMagazines");
+
+		bool result = walkedMap.Count() == m_AttachmentsMap.Count();
+
+		foreach (string slot, TStringArray walkedClasses: walkedMap)
+		{
+			TStringArray indexedClasses = m_AttachmentsMap[slot];
+			if (!indexedClasses || indexedClasses.Count() != walkedClasses.Count())
+			{
+				EXPrint(ToString() + "::CheckAttachmentsMapParity - slot " + slot + " mismatch");
+				result = false;
+			}
+		}
+
+		EXPrint(ToString() + "::CheckAttachmentsMapParity - " + walkedMap.Count() + " slots, parity " + result);
+
+		return result;
 	}
+#endif
 	
 	static bool IsWeapon(string className)
 	{
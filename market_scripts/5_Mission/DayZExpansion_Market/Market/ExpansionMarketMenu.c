@@ -260,10 +260,7 @@ class ExpansionMarketMenu: ExpansionScriptViewMenu
 		
 		for (int i = 0; i < m_PlayerItems.Count(); i++)
 		{
-			string itemName = m_PlayerItems[i].ClassName;
-			itemName.ToLower();
-			
-			itemName = m_MarketModule.GetMarketItemClassName(m_TraderMarket, itemName);
+			string itemName = m_MarketModule.GetMarketItemClassName(m_TraderMarket, ExpansionMarketClassName.Normalize(m_PlayerItems[i].ClassName));
 
 			if (itemName == name)
 			{
@@ -118,10 +118,7 @@ class ExpansionMenuDialog_MarketConfirmSell: ExpansionDialogBase
 				
 		for (int j = 0; j < items.Count(); j++)
 		{
-			string itemName = items[j].ClassName;
-			itemName.ToLower();
-			
-			itemName = marketModule.GetMarketItemClassName(marketModule.GetTrader().GetTraderMarket(), itemName);
+			string itemName = marketModule.GetMarketItemClassName(marketModule.GetTrader().GetTraderMarket(), ExpansionMarketClassName.Normalize(items[j].ClassName));
 
 			if (itemName == m_MarketMenu.GetSelectedMarketItem().ClassName)
 			{
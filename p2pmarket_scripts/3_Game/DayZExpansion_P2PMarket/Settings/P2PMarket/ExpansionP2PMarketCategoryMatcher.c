@@ -0,0 +1,209 @@
+/**
+ * ExpansionP2PMarketCategoryMatcher.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2025 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+class ExpansionP2PMarketCategoryMatch
+{
+	//! Bit N of word N / 32 is set if the included/excluded rules of compiled rule N (category or sub-category) match
+	ref TIntArray m_RuleBits = {};
+
+	//! Category and sub-category a listing of this type is counted in (first match), -1 if none
+	int m_CategoryIndex = -1;
+	int m_SubCategoryIndex = -1;
+
+	void SetRuleBit(int ruleIndex)
+	{
+		int word = ruleIndex / 32;
+		while (m_RuleBits.Count() <= word)
+		{
+			m_RuleBits.Insert(0);
+		}
+
+		m_RuleBits[word] = m_RuleBits[word] | (1 << (ruleIndex % 32));
+	}
+
+	bool IsRuleBitSet(int ruleIndex)
+	{
+		int word = ruleIndex / 32;
+		if (ruleIndex < 0 || word >= m_RuleBits.Count())
+			return false;
+
+		return (m_RuleBits[word] & (1 << (ruleIndex % 32))) != 0;
+	}
+
+	bool Matches(ExpansionP2PMarketMenuCategoryBase category)
+	{
+		return IsRuleBitSet(category.GetRuleIndex());
+	}
+}
+
+//! Compiles P2P market menu category rules into a flat rule table once per settings load and evaluates it once per type name.
+//! Server and client share it through ExpansionP2PMarketSettings::GetCategoryMatch.
+class ExpansionP2PMarketCategoryMatcher
+{
+	protected ref array<ExpansionP2PMarketMenuCategory> m_Categories;
+
+	//! Rule table, indexed by rule index. Sub-category rules follow the rule of their category.
+	protected ref array<ExpansionP2PMarketMenuCategoryBase> m_Rules;
+	protected ref array<bool> m_IsSubCategoryRule;
+
+	protected ref map<string, ref ExpansionP2PMarketCategoryMatch> m_Matches;
+
+	void ExpansionP2PMarketCategoryMatcher(array<ref ExpansionP2PMarketMenuCategory> categories)
+	{
+		m_Categories = new array<ExpansionP2PMarketMenuCategory>;
+		m_Rules = new array<ExpansionP2PMarketMenuCategoryBase>;
+		m_IsSubCategoryRule = new array<bool>;
+		m_Matches = new map<string, ref ExpansionP2PMarketCategoryMatch>;
+
+		Compile(categories);
+	}
+
+	protected void Compile(array<ref ExpansionP2PMarketMenuCategory> categories)
+	{
+		foreach (ExpansionP2PMarketMenuCategory menuCategory: categories)
+		{
+			if (!menuCategory)
+				continue;
+
+			m_Categories.Insert(menuCategory);
+			AddRule(menuCategory, false);
+
+			array<ref ExpansionP2PMarketMenuSubCategory> subCategories = menuCategory.GetSubCategories();
+			if (!subCategories)
+				continue;
+
+			foreach (ExpansionP2PMarketMenuSubCategory menuSubCategory: subCategories)
+			{
+				if (menuSubCategory)
+					AddRule(menuSubCategory, true);
+			}
+		}
+	}
+
+	protected void AddRule(ExpansionP2PMarketMenuCategoryBase category, bool isSubCategory)
+	{
+		category.SetRuleIndex(m_Rules.Insert(category));
+		m_IsSubCategoryRule.Insert(isSubCategory);
+	}
+
+	ExpansionP2PMarketCategoryMatch Match(string className)
+	{
+		ExpansionP2PMarketCategoryMatch match;
+		if (m_Matches.Find(className, match))
+			return match;
+
+		match = Compute(className);
+		m_Matches.Insert(className, match);
+
+		return match;
+	}
+
+	protected ExpansionP2PMarketCategoryMatch Compute(string className)
+	{
+		ExpansionP2PMarketCategoryMatch match = new ExpansionP2PMarketCategoryMatch;
+
+		foreach (int ruleIndex, ExpansionP2PMarketMenuCategoryBase rule: m_Rules)
+		{
+			if (EvaluateRule(className, rule, m_IsSubCategoryRule[ruleIndex]))
+				match.SetRuleBit(ruleIndex);
+		}
+
+		//! Listing is counted in the first matching category and the first matching sub-category of that category
+		foreach (ExpansionP2PMarketMenuCategory menuCategory: m_Categories)
+		{
+			if (!match.Matches(menuCategory))
+				continue;
+
+			match.m_CategoryIndex = menuCategory.GetCategoryIndex();
+
+			array<ref ExpansionP2PMarketMenuSubCategory> subCategories = menuCategory.GetSubCategories();
+			if (subCategories)
+			{
+				foreach (ExpansionP2PMarketMenuSubCategory menuSubCategory: subCategories)
+				{
+					if (menuSubCategory && match.Matches(menuSubCategory))
+					{
+						match.m_SubCategoryIndex = menuSubCategory.GetSubCategoryIndex();
+						break;
+					}
+				}
+			}
+
+			break;
+		}
+
+		return match;
+	}
+
+	//! An empty included list means "everything" for categories but "nothing" for sub-categories
+	static bool EvaluateRule(string className, ExpansionP2PMarketMenuCategoryBase rule, bool isSubCategory)
+	{
+		TStringArray included = rule.GetIncluded();
+		TStringArray excluded = rule.GetExcluded();
+
+		bool isIncluded;
+		bool isExcluded;
+		if (isSubCategory)
+		{
+			isIncluded = !included || ExpansionStatic.IsAnyOf(className, included);
+			isExcluded = excluded && ExpansionStatic.IsAnyOf(className, excluded);
+		}
+		else
+		{
+			isIncluded = !included || included.Count() == 0 || ExpansionStatic.IsAnyOf(className, included);
+			isExcluded = excluded && excluded.Count() > 0 && ExpansionStatic.IsAnyOf(className, excluded);
+		}
+
+		return isIncluded && !isExcluded;
+	}
+
+	int Count()
+	{
+		return m_Matches.Count();
+	}
+
+	int GetRulesCount()
+	{
+		return m_Rules.Count();
+	}
+
+#ifdef EXPANSIONMODP2PMARKET_DEBUG
+	//! Compares the compiled rule table against direct rule evaluation for every class in the given config path
+	int CheckParity(string path)
+	{
+		int start = TickCount(0);
+		int mismatches;
+		int count = GetGame().ConfigGetChildrenCount(path);
+
+		for (int i = 0; i < count; i++)
+		{
+			string className;
+			GetGame().ConfigGetChildName(path, i, className);
+
+			ExpansionP2PMarketCategoryMatch match = Match(className);
+
+			foreach (int ruleIndex, ExpansionP2PMarketMenuCategoryBase rule: m_Rules)
+			{
+				if (match.IsRuleBitSet(ruleIndex) != EvaluateRule(className, rule, m_IsSubCategoryRule[ruleIndex]))
+				{
+					EXPrint(ToString() + "::CheckParity - Mismatch for " + className + " rule " + ruleIndex + " (" + rule.GetDisplayName() + ")");
+					mismatches++;
+				}
+			}
+		}
+
+		EXPrint(ToString() + "::CheckParity - " + path + ": " + count + " classes x " + m_Rules.Count() + " rules, " + mismatches + " mismatches, " + (TickCount(start) / 10000.0) + " ms");
+
+		return mismatches;
+	}
+#endif
+}
@@ -14,6 +14,9 @@ class ExpansionP2PMarketMenuCategoryBase
 {
 	[NonSerialized()]
 	protected int m_CategoryIndex = -1;
+
+	[NonSerialized()]
+	protected int m_RuleIndex = -1;
 	
 	protected string DisplayName;
 	protected string IconPath;
@@ -76,6 +79,17 @@ class ExpansionP2PMarketMenuCategoryBase
 		return m_CategoryIndex;
 	}
 
+	//! Index in the rule table of ExpansionP2PMarketCategoryMatcher
+	void SetRuleIndex(int index)
+	{
+		m_RuleIndex = index;
+	}
+
+	int GetRuleIndex()
+	{
+		return m_RuleIndex;
+	}
+
 	void OnSend(ParamsWriteContext ctx)
 	{
 		ctx.Write(m_CategoryIndex);
@@ -264,14 +278,18 @@ class ExpansionP2PMarketSettingsBase: ExpansionSettingBase
 
 class ExpansionP2PMarketSettings: ExpansionP2PMarketSettingsBase
 {
-	static const int VERSION = 3;
+	static const int VERSION = 4;
 
 	int SalesDepositTime;
 	bool DisallowUnpersisted;
+	bool QuarantineOrphanedEntityStorage;
 
 	[NonSerialized()]
 	bool m_IsLoaded;
 
+	[NonSerialized()]
+	protected ref ExpansionP2PMarketCategoryMatcher m_CategoryMatcher;
+
 	void ExpansionP2PMarketSettings()
 	{
 	#ifdef EXPANSIONTRACE
@@ -314,6 +332,7 @@ class ExpansionP2PMarketSettings: ExpansionP2PMarketSettingsBase
 			}
 		}
 
+		m_CategoryMatcher = null;
 		m_IsLoaded = true;
 
 		ExpansionSettings.SI_P2PMarket.Invoke();
@@ -383,6 +402,7 @@ class ExpansionP2PMarketSettings: ExpansionP2PMarketSettingsBase
 
 		SalesDepositTime = s.SalesDepositTime;
 		DisallowUnpersisted = s.DisallowUnpersisted;
+		QuarantineOrphanedEntityStorage = s.QuarantineOrphanedEntityStorage;
 
 		ExpansionP2PMarketSettingsBase sb = s;
 		CopyInternal(sb);
@@ -401,6 +421,8 @@ class ExpansionP2PMarketSettings: ExpansionP2PMarketSettingsBase
 		ListingPricePercent = s.ListingPricePercent;
 		ExcludedClassNames = s.ExcludedClassNames;
 		MenuCategories = s.MenuCategories;
+
+		m_CategoryMatcher = null;
 	}
 
 	override bool IsLoaded()
@@ -408,6 +430,26 @@ class ExpansionP2PMarketSettings: ExpansionP2PMarketSettingsBase
 		return m_IsLoaded;
 	}
 
+	//! Categories and sub-categories the given type name matches, compiled on first use after (re)loading the settings
+	ExpansionP2PMarketCategoryMatch GetCategoryMatch(string className)
+	{
+		return GetCategoryMatcher().Match(className);
+	}
+
+	ExpansionP2PMarketCategoryMatcher GetCategoryMatcher()
+	{
+		if (!m_CategoryMatcher)
+			m_CategoryMatcher = new ExpansionP2PMarketCategoryMatcher(MenuCategories);
+
+		return m_CategoryMatcher;
+	}
+
+	//! Needs to be called after MenuCategories were changed at runtime
+	void InvalidateCategoryMatcher()
+	{
+		m_CategoryMatcher = null;
+	}
+
 	override void Unload()
 	{
 		m_IsLoaded = false;
@@ -443,9 +485,13 @@ class ExpansionP2PMarketSettings: ExpansionP2PMarketSettingsBase
 				else
 				{
 					JsonFileLoader<ExpansionP2PMarketSettings>.JsonLoadFile(EXPANSION_P2PMARKET_SETTINGS, this);
-					DisallowUnpersisted = settingsDefault.DisallowUnpersisted;
+
+					if (settingsBase.m_Version < 3)
+						DisallowUnpersisted = settingsDefault.DisallowUnpersisted;
 				}
 
+				QuarantineOrphanedEntityStorage = settingsDefault.QuarantineOrphanedEntityStorage;
+
 				m_Version = VERSION;
 				save = true;
 			}
@@ -466,6 +512,8 @@ class ExpansionP2PMarketSettings: ExpansionP2PMarketSettingsBase
 			Save();
 		}
 
+		m_CategoryMatcher = null;
+
 		return bmSettingsExist;
 	}
 
@@ -502,6 +550,7 @@ class ExpansionP2PMarketSettings: ExpansionP2PMarketSettingsBase
 		ListingPricePercent = 30; //! 30% of the given listing price need to be paied to list a item.
 		SalesDepositTime = 691200; //! 8 days by default.
 		DisallowUnpersisted = false;
+		QuarantineOrphanedEntityStorage = false; //! Move entity storage files without listing to a quarantine folder on load.
 
 		DefaultMenuCategories();
 
@@ -15,6 +15,7 @@ class ExpansionP2PMarketCategoryListings
 	int m_CategoryIndex = -1;
 	int m_SubCategoryIndex = -1;
 	int m_Count;
+	int m_Version; //! Server, category listings version of the last count change
 	
 	void OnSend(ParamsWriteContext ctx)
 	{
@@ -10,9 +10,50 @@
  *
 */
 
+//! Server. Authoritative per-player counters, only changed through ExpansionP2PMarketModule::AddListing, AddSoldListing,
+//! RemoveListing and listing data loading, so reading them never needs to walk the listings.
 class ExpansionP2PMarketCounters
 {
 	int m_OwnedListingsCount;
-	int m_SoldListingsCount;
-	int m_SoldTotalIncome;
+	int m_SoldListingsCount; //! Sales not retrieved yet
+	int m_SoldTotalIncome; //! Income of sales not retrieved yet
+
+	void OnListingAdded()
+	{
+		m_OwnedListingsCount++;
+	}
+
+	void OnListingRemoved()
+	{
+		m_OwnedListingsCount--;
+	}
+
+	void OnSaleAdded(int price)
+	{
+		m_SoldListingsCount++;
+		m_SoldTotalIncome += price;
+	}
+
+	void OnSaleRemoved(int price)
+	{
+		m_SoldListingsCount--;
+		m_SoldTotalIncome -= price;
+	}
+
+	bool IsEqual(ExpansionP2PMarketCounters other)
+	{
+		return m_OwnedListingsCount == other.m_OwnedListingsCount && m_SoldListingsCount == other.m_SoldListingsCount && m_SoldTotalIncome == other.m_SoldTotalIncome;
+	}
+
+	void Copy(ExpansionP2PMarketCounters other)
+	{
+		m_OwnedListingsCount = other.m_OwnedListingsCount;
+		m_SoldListingsCount = other.m_SoldListingsCount;
+		m_SoldTotalIncome = other.m_SoldTotalIncome;
+	}
+
+	string ToDebugString()
+	{
+		return string.Format("owned %1, sold %2, income %3", m_OwnedListingsCount, m_SoldListingsCount, m_SoldTotalIncome);
+	}
 };
\ No newline at end of file
@@ -0,0 +1,148 @@
+/**
+ * ExpansionP2PMarketGlobalID.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2025 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+//! Fixed-width listing global ID. Hex text (used for file names, logs and as hash map key) and hash are computed once.
+class ExpansionP2PMarketGlobalID
+{
+	int m_ID[4];
+	protected int m_Hash;
+	protected string m_Text;
+
+	void ExpansionP2PMarketGlobalID(TIntArray id)
+	{
+		for (int i = 0; i < 4; ++i)
+		{
+			m_ID[i] = id[i];
+		}
+
+		m_Text = ExpansionStatic.IntToHex(id);
+		m_Hash = m_Text.Hash();
+	}
+
+	bool IsEqual(TIntArray id)
+	{
+		if (!id || id.Count() != 4)
+			return false;
+
+		for (int i = 0; i < 4; ++i)
+		{
+			if (m_ID[i] != id[i])
+				return false;
+		}
+
+		return true;
+	}
+
+	bool IsEqual(ExpansionP2PMarketGlobalID other)
+	{
+		if (m_Hash != other.m_Hash)
+			return false;
+
+		for (int i = 0; i < 4; ++i)
+		{
+			if (m_ID[i] != other.m_ID[i])
+				return false;
+		}
+
+		return true;
+	}
+
+	bool IsValid()
+	{
+		for (int i = 0; i < 4; ++i)
+		{
+			if (m_ID[i] == 0)
+				return false;
+		}
+
+		return true;
+	}
+
+	int GetHash()
+	{
+		return m_Hash;
+	}
+
+	string GetText()
+	{
+		return m_Text;
+	}
+}
+
+//! Server. Listings by global ID per trader, kept alongside the listing arrays of ExpansionP2PMarketModule.
+class ExpansionP2PMarketListingIndex
+{
+	protected ref map<int, ref map<string, ExpansionP2PMarketListing>> m_Listings = new map<int, ref map<string, ExpansionP2PMarketListing>>;
+
+	void Insert(ExpansionP2PMarketListing listing)
+	{
+		int traderID = listing.GetTraderID();
+
+		map<string, ExpansionP2PMarketListing> traderListings = m_Listings[traderID];
+		if (!traderListings)
+		{
+			traderListings = new map<string, ExpansionP2PMarketListing>;
+			m_Listings.Insert(traderID, traderListings);
+		}
+
+		traderListings.Set(listing.GetGlobalIDKey().GetText(), listing);
+	}
+
+	void Remove(ExpansionP2PMarketListing listing)
+	{
+		int traderID = listing.GetTraderID();
+
+		map<string, ExpansionP2PMarketListing> traderListings = m_Listings[traderID];
+		if (!traderListings)
+			return;
+
+		traderListings.Remove(listing.GetGlobalIDKey().GetText());
+
+		if (!traderListings.Count())
+			m_Listings.Remove(traderID);
+	}
+
+	//! Trader ID -1 searches the listings of all traders
+	ExpansionP2PMarketListing Get(int traderID, ExpansionP2PMarketGlobalID globalID)
+	{
+		string key = globalID.GetText();
+		ExpansionP2PMarketListing listing;
+
+		if (traderID > -1)
+		{
+			map<string, ExpansionP2PMarketListing> traderListings = m_Listings[traderID];
+			if (traderListings)
+				traderListings.Find(key, listing);
+
+			return listing;
+		}
+
+		foreach (int listingsTraderID, map<string, ExpansionP2PMarketListing> listings: m_Listings)
+		{
+			if (listings.Find(key, listing))
+				return listing;
+		}
+
+		return null;
+	}
+
+	int Count()
+	{
+		int count;
+		foreach (int traderID, map<string, ExpansionP2PMarketListing> listings: m_Listings)
+		{
+			count += listings.Count();
+		}
+
+		return count;
+	}
+}
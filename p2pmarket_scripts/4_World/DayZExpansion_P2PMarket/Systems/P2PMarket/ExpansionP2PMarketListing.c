@@ -30,6 +30,19 @@ class ExpansionP2PMarketListing: ExpansionP2PMarketListingBase
 	[NonSerialized()]
 	protected int m_SubCategoryIndex = -1;
 
+	[NonSerialized()]
+	protected ref ExpansionP2PMarketGlobalID m_GlobalIDKey;
+
+	//! Server. Container item tree (body) is not resident and needs to be reloaded from the listing JSON
+	[NonSerialized()]
+	protected bool m_IsBodyUnloaded;
+	//! Server. Body is managed by ExpansionP2PMarketListingBodyCache
+	[NonSerialized()]
+	protected bool m_IsBodyCached;
+	//! Lowercase type names of the direct container items, kept resident for search
+	[NonSerialized()]
+	protected ref TStringArray m_ContainerTypeNames;
+
 	autoptr TIntArray m_GlobalID;
 	string m_OwnerUID;
 	int m_Price = -1;
@@ -101,6 +114,94 @@ class ExpansionP2PMarketListing: ExpansionP2PMarketListingBase
 		return m_GlobalID;
 	}
 
+	//! Global ID with cached hex text and hash, rebuilt only if m_GlobalID changed since last call
+	ExpansionP2PMarketGlobalID GetGlobalIDKey()
+	{
+		if (!m_GlobalIDKey || !m_GlobalIDKey.IsEqual(m_GlobalID))
+			m_GlobalIDKey = new ExpansionP2PMarketGlobalID(m_GlobalID);
+
+		return m_GlobalIDKey;
+	}
+
+	override array<ref ExpansionP2PMarketContainerItem> GetContainerItems()
+	{
+		LoadBody();
+
+		return m_ContainerItems;
+	}
+
+	TStringArray GetContainerTypeNames()
+	{
+		if (!m_ContainerTypeNames)
+		{
+			m_ContainerTypeNames = new TStringArray;
+
+			//! Built before the body is unloaded (see UnloadBody), so m_ContainerItems is resident here
+			foreach (ExpansionP2PMarketContainerItem containerItem: m_ContainerItems)
+			{
+				string typeName = containerItem.GetClassName();
+				typeName.ToLower();
+				m_ContainerTypeNames.Insert(typeName);
+			}
+		}
+
+		return m_ContainerTypeNames;
+	}
+
+	bool IsBodyLoaded()
+	{
+		return !m_IsBodyUnloaded;
+	}
+
+	//! Server. Keep body resident until it falls out of ExpansionP2PMarketListingBodyCache
+	void CacheBody()
+	{
+		m_IsBodyCached = true;
+		ExpansionP2PMarketListingBodyCache.Touch(this);
+	}
+
+	//! Server. Drop the container item tree, it will be reloaded from the listing JSON on next access
+	void UnloadBody()
+	{
+		if (m_IsBodyUnloaded)
+			return;
+
+		GetContainerTypeNames();
+
+		//! Don't clear, the array may be shared with a copy of this listing (see CopyFromBaseClass)
+		m_ContainerItems = new array<ref ExpansionP2PMarketContainerItem>;
+		m_IsBodyUnloaded = true;
+		m_IsBodyCached = true;
+	}
+
+	bool LoadBody()
+	{
+		if (m_IsBodyUnloaded)
+		{
+			string fileName = GetListingFileName();
+
+			ExpansionP2PMarketListing data;
+			if (!ExpansionJsonFileParser<ExpansionP2PMarketListing>.Load(fileName, data))
+			{
+				EXError.Error(this, "::LoadBody - Could not load listing file=" + fileName);
+				return false;
+			}
+
+			foreach (ExpansionP2PMarketContainerItem containerItem: data.m_ContainerItems)
+			{
+				containerItem.OnLoad();
+			}
+
+			m_ContainerItems = data.m_ContainerItems;
+			m_IsBodyUnloaded = false;
+		}
+
+		if (m_IsBodyCached)
+			ExpansionP2PMarketListingBodyCache.Touch(this);
+
+		return true;
+	}
+
 	string GetOwnerUID()
 	{
 		return m_OwnerUID;
@@ -159,7 +260,7 @@ class ExpansionP2PMarketListing: ExpansionP2PMarketListingBase
 
 	string GetEntityStorageBaseName()
 	{
-		return ExpansionStatic.IntToHex(m_GlobalID);
+		return GetGlobalIDKey().GetText();
 	}
 	
 	string GetListingDirectory()
@@ -267,6 +368,7 @@ class ExpansionP2PMarketListing: ExpansionP2PMarketListingBase
 	
 	void Copy(ExpansionP2PMarketListing listing)
 	{
+		listing.LoadBody();
 		CopyFromBaseClass(listing);
 		
 		m_TraderID = listing.m_TraderID;
@@ -378,6 +480,13 @@ class ExpansionP2PMarketListing: ExpansionP2PMarketListingBase
 
 	static void Save(ExpansionP2PMarketListing listingData)
 	{
+		//! Make sure container items are written back
+		if (!listingData.LoadBody())
+		{
+			EXError.Error(null, "ExpansionP2PMarketListing::Save - Body of " + listingData.GetEntityStorageBaseName() + " could not be loaded, not overwriting listing file");
+			return;
+		}
+
 		string listingsPath = listingData.GetListingDirectory();
 		if (!FileExist(listingsPath) && !ExpansionStatic.MakeDirectoryRecursive(listingsPath))
 		{
@@ -417,17 +526,9 @@ class ExpansionP2PMarketListing: ExpansionP2PMarketListingBase
 		ctx.Write(m_Rarity);
 		#endif
 		
+		//! Only the resident container type names, the container item tree is sent with the listing details
 		if (writeContainerItems)
-		{
-			int containerItemsCount = m_ContainerItems.Count();
-			ctx.Write(containerItemsCount);
-	
-			for (int j = 0; j < containerItemsCount; j++)
-			{
-				ExpansionP2PMarketContainerItem containerItem = m_ContainerItems[j];
-				containerItem.OnSendBasic(ctx);
-			}
-		}
+			ctx.Write(GetContainerTypeNames());
 	}
 	
 	bool OnRecieveBasic(ParamsReadContext ctx, bool readContainerItems = true)
@@ -544,25 +645,23 @@ class ExpansionP2PMarketListing: ExpansionP2PMarketListingBase
 
 		if (readContainerItems)
 		{
-			int containerItemsCount;
-			if (!ctx.Read(containerItemsCount))
+			TStringArray containerTypeNames;
+			if (!ctx.Read(containerTypeNames))
 			{
-				Error(ToString() + "::OnRecieveBasic - containerItemsCount");
+				Error(ToString() + "::OnRecieveBasic - containerTypeNames");
 				return false;
 			}
-			
+
+			m_ContainerTypeNames = containerTypeNames;
+
 			if (m_ContainerItems.Count())
 				m_ContainerItems.Clear();
-	
-			for (int j = 0; j < containerItemsCount; j++)
+
+			//! Type only, enough for preview and item count. Full container items are received with the listing details
+			foreach (string containerTypeName: containerTypeNames)
 			{
 				ExpansionP2PMarketContainerItem containerItem = new ExpansionP2PMarketContainerItem();
-				if (!containerItem.OnRecieveBasic(ctx))
-				{
-					Error(ToString() + "::OnRecieveBasic - containerItem");
-					return false;
-				}
-	
+				containerItem.SetClassName(containerTypeName);
 				m_ContainerItems.Insert(containerItem);
 			}
 		}
@@ -573,6 +672,7 @@ class ExpansionP2PMarketListing: ExpansionP2PMarketListingBase
 	void OnSendDetails(ParamsWriteContext ctx)
 	{
 		OnSendBasic(ctx, false);
+		LoadBody();
 		
 		int containerItemsCount = m_ContainerItems.Count();
 		ctx.Write(containerItemsCount);
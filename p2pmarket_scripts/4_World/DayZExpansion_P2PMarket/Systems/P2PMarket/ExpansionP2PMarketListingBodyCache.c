@@ -0,0 +1,143 @@
+/**
+ * ExpansionP2PMarketListingBodyCache.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2025 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+class ExpansionP2PMarketListingBodyCacheNode
+{
+	ExpansionP2PMarketListing m_Listing;
+	string m_Key;
+
+	ExpansionP2PMarketListingBodyCacheNode m_Prev;
+	ref ExpansionP2PMarketListingBodyCacheNode m_Next;
+}
+
+//! Server. Listings whose container item tree (body) is currently resident, least recently used first.
+//! Once more than CAPACITY bodies are resident, the least recently used one is unloaded again
+//! and will be reloaded from the listing JSON on next access (see ExpansionP2PMarketListing::LoadBody).
+//! Doubly linked list indexed by global ID, so touching a listing is O(1).
+class ExpansionP2PMarketListingBodyCache
+{
+	static const int CAPACITY = 512;
+
+	protected static ref map<string, ExpansionP2PMarketListingBodyCacheNode> s_Nodes = new map<string, ExpansionP2PMarketListingBodyCacheNode>;
+	//! Least recently used, owns the list through m_Next
+	protected static ref ExpansionP2PMarketListingBodyCacheNode s_Oldest;
+	//! Most recently used
+	protected static ExpansionP2PMarketListingBodyCacheNode s_Newest;
+
+	#ifdef EXPANSIONMODP2PMARKET_DEBUG
+	protected static int s_LoadCount;
+	protected static int s_UnloadCount;
+	#endif
+
+	//! Mark listing body as most recently used, unload bodies over capacity
+	static void Touch(ExpansionP2PMarketListing listing)
+	{
+		string key = listing.GetEntityStorageBaseName();
+
+		ExpansionP2PMarketListingBodyCacheNode node;
+		if (s_Nodes.Find(key, node))
+		{
+			if (node == s_Newest)
+				return;
+
+			Unlink(node);
+		}
+		else
+		{
+			node = new ExpansionP2PMarketListingBodyCacheNode;
+			node.m_Listing = listing;
+			node.m_Key = key;
+			s_Nodes.Insert(key, node);
+			#ifdef EXPANSIONMODP2PMARKET_DEBUG
+			s_LoadCount++;
+			#endif
+		}
+
+		Append(node);
+
+		while (s_Nodes.Count() > CAPACITY)
+		{
+			ExpansionP2PMarketListingBodyCacheNode oldest = s_Oldest;
+			Unlink(oldest);
+			s_Nodes.Remove(oldest.m_Key);
+
+			//! Listing may already have been deleted
+			if (oldest.m_Listing)
+			{
+				oldest.m_Listing.UnloadBody();
+				#ifdef EXPANSIONMODP2PMARKET_DEBUG
+				s_UnloadCount++;
+				#endif
+			}
+		}
+	}
+
+	static void Remove(ExpansionP2PMarketListing listing)
+	{
+		string key = listing.GetEntityStorageBaseName();
+
+		ExpansionP2PMarketListingBodyCacheNode node;
+		if (!s_Nodes.Find(key, node))
+			return;
+
+		Unlink(node);
+		s_Nodes.Remove(key);
+	}
+
+	static bool Contains(ExpansionP2PMarketListing listing)
+	{
+		return s_Nodes.Contains(listing.GetEntityStorageBaseName());
+	}
+
+	static int Count()
+	{
+		return s_Nodes.Count();
+	}
+
+	protected static void Append(ExpansionP2PMarketListingBodyCacheNode node)
+	{
+		node.m_Prev = s_Newest;
+
+		if (s_Newest)
+			s_Newest.m_Next = node;
+		else
+			s_Oldest = node;
+
+		s_Newest = node;
+	}
+
+	//! Caller has to hold a reference to `node`, the list may have been its only owner
+	protected static void Unlink(ExpansionP2PMarketListingBodyCacheNode node)
+	{
+		ExpansionP2PMarketListingBodyCacheNode next = node.m_Next;
+
+		if (node.m_Prev)
+			node.m_Prev.m_Next = next;
+		else
+			s_Oldest = next;
+
+		if (next)
+			next.m_Prev = node.m_Prev;
+		else
+			s_Newest = node.m_Prev;
+
+		node.m_Prev = null;
+		node.m_Next = null;
+	}
+
+	#ifdef EXPANSIONMODP2PMARKET_DEBUG
+	static string ToDebugString()
+	{
+		return "resident=" + s_Nodes.Count() + "/" + CAPACITY + " loads=" + s_LoadCount + " unloads=" + s_UnloadCount;
+	}
+	#endif
+}
@@ -0,0 +1,140 @@
+/**
+ * ExpansionP2PMarketLoader.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2025 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+//! Server. Listing files of one trader, enumerated at mission start and loaded over several frames.
+class ExpansionP2PMarketLoaderTrader
+{
+	int m_TraderID;
+	string m_ListingsPath;
+	ref TStringArray m_FileNames;
+	int m_NextFile;
+	bool m_LoadedFromOldLoc;
+	bool m_IsReady;
+
+	void ExpansionP2PMarketLoaderTrader(int traderID, string listingsPath, TStringArray fileNames, bool loadedFromOldLoc)
+	{
+		m_TraderID = traderID;
+		m_ListingsPath = listingsPath;
+		m_FileNames = fileNames;
+		m_LoadedFromOldLoc = loadedFromOldLoc;
+
+		if (!m_FileNames)
+			m_FileNames = new TStringArray;
+	}
+
+	bool HasNextFile()
+	{
+		return m_NextFile < m_FileNames.Count();
+	}
+
+	string NextFile()
+	{
+		return m_FileNames[m_NextFile++];
+	}
+}
+
+//! Server. Time-sliced loading of P2P listings after mission start.
+//! Stages: directory enumeration (mission start, see AddTrader) -> listing parse and index build (per frame, within FRAME_BUDGET_MS)
+//! -> category counts of a trader once all its listings are loaded. A trader is ready once its last stage ran,
+//! global traders only once all traders are ready (see ExpansionP2PMarketModule::IsTraderReady).
+class ExpansionP2PMarketLoader
+{
+	static const float FRAME_BUDGET_MS = 4.0;
+
+	protected ref array<ref ExpansionP2PMarketLoaderTrader> m_Traders = new array<ref ExpansionP2PMarketLoaderTrader>;
+	protected ref map<int, ExpansionP2PMarketLoaderTrader> m_TradersByID = new map<int, ExpansionP2PMarketLoaderTrader>;
+	protected int m_CurrentTrader;
+
+	protected int m_FilesCount;
+	protected int m_FilesLoaded;
+	protected int m_StartTime;
+	protected int m_Frames;
+	protected float m_LoadTime;
+	protected float m_MaxFrameTime;
+
+	void ExpansionP2PMarketLoader()
+	{
+		m_StartTime = TickCount(0);
+	}
+
+	void AddTrader(int traderID, string listingsPath, TStringArray fileNames, bool loadedFromOldLoc = false)
+	{
+		ExpansionP2PMarketLoaderTrader trader = new ExpansionP2PMarketLoaderTrader(traderID, listingsPath, fileNames, loadedFromOldLoc);
+		m_Traders.Insert(trader);
+		m_TradersByID.Insert(traderID, trader);
+		m_FilesCount += trader.m_FileNames.Count();
+	}
+
+	//! Trader whose listings are currently being loaded, null once done
+	ExpansionP2PMarketLoaderTrader GetCurrentTrader()
+	{
+		if (m_CurrentTrader < m_Traders.Count())
+			return m_Traders[m_CurrentTrader];
+
+		return null;
+	}
+
+	void OnFileLoaded()
+	{
+		m_FilesLoaded++;
+	}
+
+	void OnTraderReady(ExpansionP2PMarketLoaderTrader trader)
+	{
+		trader.m_IsReady = true;
+		m_CurrentTrader++;
+
+		EXPrint(ToString() + "::OnTraderReady - Trader ID " + trader.m_TraderID + " ready (" + trader.m_FileNames.Count() + " listing files) - " + m_CurrentTrader + "/" + m_Traders.Count() + " traders, " + GetProgress() * 100 + "% of " + m_FilesCount + " listing files");
+	}
+
+	void OnFrame(float frameTime)
+	{
+		m_Frames++;
+		m_LoadTime += frameTime;
+
+		if (frameTime > m_MaxFrameTime)
+			m_MaxFrameTime = frameTime;
+	}
+
+	bool IsDone()
+	{
+		return m_CurrentTrader >= m_Traders.Count();
+	}
+
+	bool IsTraderReady(int traderID, bool isGlobal = false)
+	{
+		if (isGlobal)
+			return IsDone();
+
+		ExpansionP2PMarketLoaderTrader trader;
+		if (m_TradersByID.Find(traderID, trader))
+			return trader.m_IsReady;
+
+		//! No such trader config loaded, nothing to wait for
+		return true;
+	}
+
+	float GetProgress()
+	{
+		if (!m_FilesCount)
+			return 1.0;
+
+		float loaded = m_FilesLoaded;
+
+		return loaded / m_FilesCount;
+	}
+
+	string ToDebugString()
+	{
+		return m_FilesLoaded + "/" + m_FilesCount + " listing files of " + m_Traders.Count() + " traders in " + m_Frames + " frames, " + m_LoadTime + " ms loading (max " + m_MaxFrameTime + " ms per frame), " + (TickCount(m_StartTime) / 10000.0) + " ms since mission start";
+	}
+}
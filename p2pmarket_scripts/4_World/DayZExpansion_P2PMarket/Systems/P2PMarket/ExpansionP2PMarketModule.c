@@ -31,15 +31,27 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 	protected ref map<int, ref array<ref ExpansionP2PMarketListing>> m_SoldListingsData = new map<int, ref array<ref ExpansionP2PMarketListing>>; //! Server
 	protected ref map<int, ref array<ref ExpansionP2PMarketCategoryListings>> m_CategoryListings = new map<int, ref array<ref ExpansionP2PMarketCategoryListings>>; //! Server & Client
 	protected ref map<int, ref map<int, ref array<ref ExpansionP2PMarketCategoryListings>>> m_TraderCategoryListings = new map<int, ref map<int, ref array<ref ExpansionP2PMarketCategoryListings>>>; //! Server & Client
-	protected ref map<string, int> m_TradingPlayers = new map<string, int>; //! Server
+	protected ref ExpansionP2PMarketSubscriptionRegistry m_Subscriptions = new ExpansionP2PMarketSubscriptionRegistry; //! Server
+	protected ref ExpansionP2PMarketSortedViews m_SortedViews = new ExpansionP2PMarketSortedViews; //! Server
+	protected ref ExpansionP2PMarketPriceIndex m_PriceIndex = new ExpansionP2PMarketPriceIndex; //! Server
+	protected ref ExpansionP2PMarketListingIndex m_ListingIndex = new ExpansionP2PMarketListingIndex; //! Server
+	protected ref ExpansionP2PMarketListingIndex m_SoldListingIndex = new ExpansionP2PMarketListingIndex; //! Server
 	protected ref map<string, ref ExpansionP2PMarketCounters> m_PlayerDataCounters = new map<string, ref ExpansionP2PMarketCounters>; //! Server
+	protected ref ExpansionP2PMarketLoader m_Loader; //! Server
 	protected int m_ListingsCount; //! Server
+	protected int m_CategoryListingsVersion; //! Server
+	protected int m_CategoryListingsEpoch; //! Server: set once per boot, versions are only comparable within the same epoch. Client: epoch of m_CategoryListingsVersions
+	protected ref map<int, int> m_CategoryListingsVersions = new map<int, int>; //! Client, last received category listings version per trader ID
+	protected ExpansionP2PMarketListingSortKey m_ListingsSortKey; //! Client
+	protected bool m_ListingsSortReverse; //! Client
 
 	protected ref ExpansionP2PMarketPlayerInventory m_LocalEntityInventory; //! Client
 	protected ref ScriptInvoker m_ListingsInvoker; //! Client
 	protected ref ScriptInvoker m_ListingDetailsInvoker; //! Client
 	protected ref ScriptInvoker m_CallbackInvoker; //! Client
 	protected ref ScriptInvoker m_UpdateInvoker; //! Client
+	protected ref ScriptInvoker m_ListingAddedInvoker; //! Client
+	protected ref ScriptInvoker m_PriceRangeInvoker; //! Client
 	
 	protected ExpansionP2PMarketSettings m_P2PMarketSettings;
 
@@ -80,6 +92,9 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		Expansion_RegisterServerRPC("RPC_RequestListingDetails");
 		Expansion_RegisterClientRPC("RPC_SendListingDetails");
 		Expansion_RegisterClientRPC("RPC_UpdateClientRequest");
+		Expansion_RegisterClientRPC("RPC_SendListingAdded");
+		Expansion_RegisterServerRPC("RPC_RequestPriceRange");
+		Expansion_RegisterClientRPC("RPC_SendPriceRange");
 	}
 
 	protected void CreateDirectoryStructure()
@@ -95,13 +110,13 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		#endif 
 				
 		#ifdef SERVER
+		m_CategoryListingsEpoch = CF_Date.Now(true).GetTimestamp();
 		m_P2PMarketSettings = GetExpansionSettings().GetP2PMarket();
 		if (m_P2PMarketSettings.Enabled)
 		{
 			CreateDirectoryStructure();
 			LoadP2PMarketServerData();
-
-			m_Initialized = true;
+			//! m_Initialized is set once the loader finished loading all listings (see UpdateLoader)
 		}
 		#endif
 	}
@@ -135,24 +150,10 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			//! Add counter data instance for connecting player
 			ExpansionP2PMarketCounters counters = GetPlayerDataCounters(playerUID);
 			
-			//! Get all sales on player connection and display overall sold value in chat on players client
-			int totalIncome;
-			int salesCount;
-			foreach (int traderID, array<ref ExpansionP2PMarketListing>> listings: m_SoldListingsData)
+			//! Display overall value of all sales not retrieved yet in chat on players client (counters are complete once all listings are loaded)
+			if (m_Initialized && counters.m_SoldTotalIncome > 0)
 			{
-				foreach (ExpansionP2PMarketListing soldListing: listings)
-				{
-					if (soldListing.GetListingState() != ExpansionP2PMarketListingState.SOLD || soldListing.GetOwnerUID() != playerUID)
-						continue;
-
-					totalIncome += soldListing.GetPrice();
-					salesCount++;
-				}
-			}
-
-			if (totalIncome > 0)
-			{
-				Callback(cArgs.Identity, ExpansionP2PMarketModuleCallback.MsgTotalSold, "", totalIncome, salesCount);
+				Callback(cArgs.Identity, ExpansionP2PMarketModuleCallback.MsgTotalSold, "", counters.m_SoldTotalIncome, counters.m_SoldListingsCount);
 			}
 		}
 	}
@@ -200,6 +201,8 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			m_ListingDetailsInvoker = new ScriptInvoker();
 			m_CallbackInvoker = new ScriptInvoker();
 			m_UpdateInvoker = new ScriptInvoker();
+			m_ListingAddedInvoker = new ScriptInvoker();
+			m_PriceRangeInvoker = new ScriptInvoker();
 		}
 	}
 
@@ -209,6 +212,8 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
 		#endif
 		
+		m_Loader = new ExpansionP2PMarketLoader();
+
 		//! Move existing configs (if any) from old to new location
 		string dataDir = GetP2PMarketDataDirectory();
 		array<string> p2pMarketFilesExisting = ExpansionStatic.FindFilesInLocation(dataDir, ".json");
@@ -231,8 +236,138 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 				CreateDefaultP2PTraderConfig();
 		}
 		
+		//! Category counts of each trader are updated once its listings are loaded (see OnTraderListingsLoaded)
 		LoadListingCategories();
-		UpdateListingsCategoriesData();
+	}
+
+	//! Server. Loads queued listing files until the frame budget is used up
+	protected void UpdateLoader()
+	{
+		int start = TickCount(0);
+		float budget = ExpansionP2PMarketLoader.FRAME_BUDGET_MS * 10000;
+
+		ExpansionP2PMarketLoaderTrader trader = m_Loader.GetCurrentTrader();
+		while (trader && TickCount(start) < budget)
+		{
+			if (trader.HasNextFile())
+			{
+				string listingFileName = trader.NextFile();
+				string filePath = trader.m_ListingsPath + listingFileName;
+				if (!FileExist(filePath))
+					EXError.Error(this, "::UpdateLoader - Could not find and load P2P trader listing file=" + filePath);
+				else
+					LoadListingData(trader.m_TraderID, listingFileName, trader.m_ListingsPath);
+
+				m_Loader.OnFileLoaded();
+			}
+			else
+			{
+				OnTraderListingsLoaded(trader);
+				trader = m_Loader.GetCurrentTrader();
+			}
+		}
+
+		m_Loader.OnFrame(TickCount(start) / 10000.0);
+
+		if (m_Loader.IsDone())
+			OnListingsLoaded();
+	}
+
+	//! Server
+	protected void OnTraderListingsLoaded(ExpansionP2PMarketLoaderTrader trader)
+	{
+		#ifdef EXTRACE
+		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
+		#endif
+
+		int traderID = trader.m_TraderID;
+
+		//! Delete old trader listings folder
+		if (trader.m_LoadedFromOldLoc)
+		{
+			ExpansionStatic.DeleteFiles(trader.m_ListingsPath, trader.m_FileNames);
+			DeleteFile(trader.m_ListingsPath);
+		}
+
+		if (m_P2PMarketSettings.QuarantineOrphanedEntityStorage)
+			QuarantineOrphanedEntityStorage(traderID);
+
+		array<ref ExpansionP2PMarketListing> listings;
+		if (m_ListingsData.Find(traderID, listings))
+			UpdateTraderListingsCategoriesData(traderID, listings);
+
+		m_Loader.OnTraderReady(trader);
+	}
+
+	//! Server
+	protected void OnListingsLoaded()
+	{
+		#ifdef EXTRACE
+		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
+		#endif
+
+		//! Views of global traders may have been built from partially loaded listings
+		m_SortedViews.Clear();
+
+		EXPrint(ToString() + "::OnListingsLoaded - Loaded " + m_ListingsCount + " listings: " + m_Loader.ToDebugString());
+
+		m_Initialized = true;
+
+		if (GetGame().IsMultiplayer())
+			SendTotalSoldMessages();
+	}
+
+	//! Server. Players that connected while listings were still loading didn't get their total sales yet (see OnInvokeConnect)
+	protected void SendTotalSoldMessages()
+	{
+		array<Man> players = new array<Man>;
+		GetGame().GetPlayers(players);
+
+		foreach (Man player: players)
+		{
+			PlayerIdentity identity = player.GetIdentity();
+			if (!identity)
+				continue;
+
+			ExpansionP2PMarketCounters counters;
+			if (m_PlayerDataCounters.Find(identity.GetId(), counters) && counters.m_SoldTotalIncome > 0)
+				Callback(identity, ExpansionP2PMarketModuleCallback.MsgTotalSold, "", counters.m_SoldTotalIncome, counters.m_SoldListingsCount);
+		}
+	}
+
+	//! Server. Listings of the trader (of all traders for global traders) finished loading
+	bool IsTraderReady(ExpansionP2PMarketTraderConfig traderConfig)
+	{
+		if (m_Initialized)
+			return true;
+
+		if (!m_Loader)
+			return false;
+
+		return m_Loader.IsTraderReady(traderConfig.GetID(), traderConfig.IsGlobalTrader());
+	}
+
+	//! Server. Tells the player to try again later if the trader isn't ready yet
+	protected bool CheckTraderReady(ExpansionP2PMarketTraderConfig traderConfig, PlayerIdentity identity)
+	{
+		if (IsTraderReady(traderConfig))
+			return true;
+
+		CallbackError(identity, ExpansionP2PMarketModuleCallback.ErrorWarmingUp);
+
+		return false;
+	}
+
+	//! Server. Player counters (owned/sold listings) are shared by all traders and only complete once listings of all traders are loaded,
+	//! so anything reading or changing them has to wait for that, not just for the trader in question
+	protected bool CheckInitialized(PlayerIdentity identity)
+	{
+		if (m_Initialized)
+			return true;
+
+		CallbackError(identity, ExpansionP2PMarketModuleCallback.ErrorWarmingUp);
+
+		return false;
 	}
 
 	//! Server
@@ -288,6 +423,16 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 	
 			m_CategoryListings.Set(i, dataArray);
 		}
+
+		//! Recompile category rules, "Uncategorized" category was added and indices were assigned
+		m_P2PMarketSettings.InvalidateCategoryMatcher();
+		
+	#ifdef EXPANSIONMODP2PMARKET_DEBUG
+		ExpansionP2PMarketCategoryMatcher categoryMatcher = m_P2PMarketSettings.GetCategoryMatcher();
+		categoryMatcher.CheckParity("CfgVehicles");
+		categoryMatcher.CheckParity("CfgWeapons");
+		categoryMatcher.CheckParity("CfgMagazines");
+	#endif
 		
 		foreach (int index, array<ref ExpansionP2PMarketCategoryListings> lc: m_CategoryListings)
 		{
@@ -301,36 +446,7 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		//! Initialize per-trader category listings
 		foreach (int traderID, ref array<ref ExpansionP2PMarketListing> listings: m_ListingsData)
 		{
-			map<int, ref array<ref ExpansionP2PMarketCategoryListings>> traderCategoryMap = new map<int, ref array<ref ExpansionP2PMarketCategoryListings>>;
-			for (int k = 0; k < m_P2PMarketSettings.MenuCategories.Count(); ++k)
-			{
-				menuCategory = m_P2PMarketSettings.MenuCategories[k];
-				
-				dataArray = new array<ref ExpansionP2PMarketCategoryListings>;
-				categoryData = new ExpansionP2PMarketCategoryListings();
-				categoryData.m_CategoryIndex = k;
-				dataArray.Insert(categoryData);
-				
-				subCategories = menuCategory.GetSubCategories();
-				if (!subCategories)
-				{
-					traderCategoryMap.Set(k, dataArray);
-					continue;
-				}
-				
-				for (int m = 0; m < subCategories.Count(); ++m)
-				{
-					subCategory = subCategories[m];
-					subCategoryData = new ExpansionP2PMarketCategoryListings();
-					subCategoryData.m_CategoryIndex = k;
-					subCategoryData.m_SubCategoryIndex = m;
-					dataArray.Insert(subCategoryData);
-				}
-				
-				traderCategoryMap.Set(k, dataArray);
-			}
-			
-			m_TraderCategoryListings.Set(traderID, traderCategoryMap);
+			GetTraderCategoryListings(traderID);
 		}
 		
 		foreach(int tID, map<int, ref array<ref ExpansionP2PMarketCategoryListings>> tclm: m_TraderCategoryListings)
@@ -347,48 +463,44 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		}
 	}
 
-	protected void UpdateListingsCategoriesData()
+	//! Server
+	//! Returns category listings of the given trader, creating them if the trader had no listings when categories were loaded
+	protected map<int, ref array<ref ExpansionP2PMarketCategoryListings>> GetTraderCategoryListings(int traderID)
 	{
-		#ifdef EXTRACE
-		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
-		#endif
-		
-		int i;
-		ExpansionP2PMarketCategoryListings cd;
-		//! Reset all counts
-		foreach (int categoryIndex, array<ref ExpansionP2PMarketCategoryListings> categoryDataArray: m_CategoryListings)
-		{
-			for (i = 0; i < categoryDataArray.Count(); ++i)
-			{
-				cd = categoryDataArray[i];
-				if (!cd) 
-					continue;
-				
-				cd.m_Count = 0;
-			}
-		}
-		
-		foreach (int traderID, map<int, ref array<ref ExpansionP2PMarketCategoryListings>> traderCategories: m_TraderCategoryListings)
+		map<int, ref array<ref ExpansionP2PMarketCategoryListings>> traderCategoryMap = m_TraderCategoryListings[traderID];
+		if (traderCategoryMap)
+			return traderCategoryMap;
+
+		traderCategoryMap = new map<int, ref array<ref ExpansionP2PMarketCategoryListings>>;
+		for (int k = 0; k < m_P2PMarketSettings.MenuCategories.Count(); ++k)
 		{
-			foreach (int tCategoryIndex, array<ref ExpansionP2PMarketCategoryListings> tCategoryDataArray: traderCategories)
+			ExpansionP2PMarketMenuCategory menuCategory = m_P2PMarketSettings.MenuCategories[k];
+			
+			array<ref ExpansionP2PMarketCategoryListings> dataArray = new array<ref ExpansionP2PMarketCategoryListings>;
+			ExpansionP2PMarketCategoryListings categoryData = new ExpansionP2PMarketCategoryListings();
+			categoryData.m_CategoryIndex = k;
+			dataArray.Insert(categoryData);
+			
+			array<ref ExpansionP2PMarketMenuSubCategory> subCategories = menuCategory.GetSubCategories();
+			if (subCategories)
 			{
-				for (i = 0; i < tCategoryDataArray.Count(); ++i)
+				for (int m = 0; m < subCategories.Count(); ++m)
 				{
-					cd = tCategoryDataArray[i];
-					if (!cd) 
-						continue;
-					
-					cd.m_Count = 0;
+					ExpansionP2PMarketCategoryListings subCategoryData = new ExpansionP2PMarketCategoryListings();
+					subCategoryData.m_CategoryIndex = k;
+					subCategoryData.m_SubCategoryIndex = m;
+					dataArray.Insert(subCategoryData);
 				}
 			}
+			
+			traderCategoryMap.Set(k, dataArray);
 		}
+		
+		m_TraderCategoryListings.Set(traderID, traderCategoryMap);
 
-		foreach (int lTraderID, array<ref ExpansionP2PMarketListing> listings: m_ListingsData)
-		{
-			UpdateTraderListingsCategoriesData(lTraderID, listings);
-		}
+		return traderCategoryMap;
 	}
-	
+
 	protected void UpdateTraderListingsCategoriesData(int traderID, array<ref ExpansionP2PMarketListing> listings)
 	{
 		#ifdef EXTRACE
@@ -420,158 +532,60 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			return false;
 		}
 
-		bool updatedTrader = ExUpdateListingCategoryData(listing, removed, m_CategoryListings);
-		bool updatedGlobal = ExUpdateListingCategoryData(listing, removed, m_TraderCategoryListings[traderID], false);
+		ExpansionP2PMarketCategoryMatch match = m_P2PMarketSettings.GetCategoryMatch(listing.GetClassName());
+		if (match.m_CategoryIndex == -1)
+			return false;
+
+		listing.SetCategoryIndex(match.m_CategoryIndex);
+		listing.SetSubCategoryIndex(match.m_SubCategoryIndex);
+
+		m_CategoryListingsVersion++;
+
+		bool updatedGlobal = ExUpdateListingCategoryData(match, removed, m_CategoryListings);
+		bool updatedTrader = ExUpdateListingCategoryData(match, removed, GetTraderCategoryListings(traderID));
 
 		return (updatedGlobal && updatedTrader);
 	}
 	
-	protected bool ExUpdateListingCategoryData(ExpansionP2PMarketListing listing, bool removed, map<int, ref array<ref ExpansionP2PMarketCategoryListings>> categoryMap, bool updateListing = true)
+	protected bool ExUpdateListingCategoryData(ExpansionP2PMarketCategoryMatch match, bool removed, map<int, ref array<ref ExpansionP2PMarketCategoryListings>> categoryMap)
 	{
-		if (!m_P2PMarketSettings)
-		{
-			EXError.Error(this, "::ExUpdateListingCategoryData - Could not get P2P market settings!");
-			return false;
-		}
-		
-		if (!m_P2PMarketSettings.MenuCategories)
+		if (!categoryMap)
 		{
-			ErrorEx("Could not get menu categories from settings!", ErrorExSeverity.ERROR);
+			ErrorEx("Could not get category map!", ErrorExSeverity.ERROR);
 			return false;
 		}
 
-		if (!categoryMap)
+		array<ref ExpansionP2PMarketCategoryListings> categoryDataArray = categoryMap[match.m_CategoryIndex];
+		if (!categoryDataArray)
 		{
-			ErrorEx("Could not get category map!", ErrorExSeverity.ERROR);
+			ErrorEx("Could not get category data array for index " + match.m_CategoryIndex, ErrorExSeverity.ERROR);
 			return false;
 		}
-		
-		string className = listing.GetClassName();
-		foreach (ExpansionP2PMarketMenuCategory menuCategory: m_P2PMarketSettings.MenuCategories)
-		{
-			if (!menuCategory)
-				continue;
-			
-			int categoryIndex = menuCategory.GetCategoryIndex();
-			string categoryName = menuCategory.GetDisplayName();
 
-			array<ref ExpansionP2PMarketCategoryListings> categoryDataArray = categoryMap[categoryIndex];
-			if (!categoryDataArray)
-			{
-				ErrorEx("Could not get category data array for index " + categoryIndex, ErrorExSeverity.ERROR);
-				continue;
-			}
-			else
-			{
-				P2PDebugPrint("Found category data array for index " + categoryIndex + " ...");
-			}
-			
-			// Pre-check inclusion/exclusion logic once
-			TStringArray included = menuCategory.GetIncluded();
-			TStringArray excluded = menuCategory.GetExcluded();
+		//! Index 0 holds the category count, index N + 1 the count of sub-category N (see LoadListingCategories)
+		UpdateCategoryListingsCount(categoryDataArray[0], removed);
 
-			bool isIncluded = !included || included.Count() == 0 || ExpansionStatic.IsAnyOf(className, included);
-			bool isExcluded = excluded && excluded.Count() > 0 && ExpansionStatic.IsAnyOf(className, excluded);
+		int subCategoryDataIndex = match.m_SubCategoryIndex + 1;
+		if (subCategoryDataIndex > 0 && subCategoryDataIndex < categoryDataArray.Count())
+			UpdateCategoryListingsCount(categoryDataArray[subCategoryDataIndex], removed);
 
-			if (!isIncluded || isExcluded)
-			{
-				P2PDebugPrint("Skipping " + className + " for category " + categoryIndex + " | Name: " + categoryName);
-				continue;
-			}
-			else
-			{
-				P2PDebugPrint("Adding " + className + " to category " + categoryIndex + " | Name: " + categoryName);
-			}
-
-			bool foundData = false;
-			bool foundSubData = false;
-
-			foreach (ExpansionP2PMarketCategoryListings categoryData: categoryDataArray)
-			{
-				if (!categoryData || categoryData.m_CategoryIndex != categoryIndex || categoryData.m_SubCategoryIndex != -1)
-					continue;
-				
-				P2PDebugPrint("Before update - categoryIndex: " + categoryIndex + " count: " + categoryData.m_Count);
-				
-				if (removed)
-				{
-					categoryData.m_Count = Math.Max(0, categoryData.m_Count - 1);
-				}
-				else
-				{
-					categoryData.m_Count++;
-				}
-				
-				P2PDebugPrint("After update - categoryIndex: " + categoryIndex + " count: " + categoryData.m_Count);
-
-				foundData = true;
-				break;
-			}
-			
-			if (updateListing)
-				listing.SetCategoryIndex(categoryIndex);
-
-			// Process subcategories using direct lookup
-			array<ref ExpansionP2PMarketMenuSubCategory> subCategories = menuCategory.GetSubCategories();
-			foreach (ExpansionP2PMarketMenuSubCategory menuSubCategory: subCategories)
-			{
-				if (!menuSubCategory)
-					continue;
-
-				int subCategoryIndex = menuSubCategory.GetSubCategoryIndex();
-				string subCategoryName = menuSubCategory.GetDisplayName();
-
-				// Pre-check inclusion/exclusion logic once
-				TStringArray subIncluded = menuSubCategory.GetIncluded();
-				TStringArray subExcluded = menuSubCategory.GetExcluded();
-
-				bool isSubIncluded = !subIncluded || ExpansionStatic.IsAnyOf(className, subIncluded);
-				bool isSubExcluded = subExcluded && ExpansionStatic.IsAnyOf(className, subExcluded);
-
-				if (!isSubIncluded || isSubExcluded)
-				{
-					P2PDebugPrint("Skipping " + className + " for sub category " + subCategoryIndex + " | Name: " + subCategoryName);
-					continue;
-				}
-				else
-				{
-					P2PDebugPrint("Adding " + className + " to sub category " + subCategoryIndex + " | Name: " + subCategoryName);
-				}
-				
-				foreach (ExpansionP2PMarketCategoryListings subCategoryData: categoryDataArray)
-				{
-					if (!subCategoryData || subCategoryData.m_SubCategoryIndex != subCategoryIndex)
-						continue;
-					
-					P2PDebugPrint("Before update - subCategoryIndex: " + subCategoryIndex + " count: " + subCategoryData.m_Count);
-					
-					if (removed)
-					{
-						subCategoryData.m_Count = Math.Max(0, subCategoryData.m_Count - 1);
-					}
-					else
-					{
-						subCategoryData.m_Count++;
-					}
-					
-					P2PDebugPrint("After update - subCategoryIndex: " + subCategoryIndex + " count: " + subCategoryData.m_Count);
-
-					foundSubData = true;
-					break;
-				}
-				
-				if (updateListing)
-					listing.SetSubCategoryIndex(subCategoryIndex);
-
-				if (foundSubData)
-					break;
-			}
+		return true;
+	}
 
-			if (foundData)
-				break;
+	protected void UpdateCategoryListingsCount(ExpansionP2PMarketCategoryListings categoryData, bool removed)
+	{
+		if (removed)
+		{
+			categoryData.m_Count = Math.Max(0, categoryData.m_Count - 1);
 		}
+		else
+		{
+			categoryData.m_Count++;
+		}
+
+		categoryData.m_Version = m_CategoryListingsVersion;
 
-		return (foundData || foundSubData);
+		P2PDebugPrint("Updated count - categoryIndex: " + categoryData.m_CategoryIndex + " subCategoryIndex: " + categoryData.m_SubCategoryIndex + " count: " + categoryData.m_Count);
 	}
 
 	protected void CreateDefaultP2PTraderConfig()
@@ -654,36 +668,65 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		{
 			//! Load from new location
 			traderListingsPath = GetP2PMarketDataDirectory() + "traderID_" + traderID + "\\listings\\"; //! New trader listings path
-			if (!FileExist(traderListingsPath))
-				return;
 		}
 		else
 		{
 			loadedFromOldLoc = true;
 		}
 		
-		array<string> traderListings = ExpansionStatic.FindFilesInLocation(traderListingsPath, ".json");
-		if (traderListings && traderListings.Count() > 0)
+		array<string> traderListings;
+		if (FileExist(traderListingsPath))
+			traderListings = ExpansionStatic.FindFilesInLocation(traderListingsPath, ".json");
+
+		//! Listing files are loaded over the next frames (see UpdateLoader)
+		m_Loader.AddTrader(traderID, traderListingsPath, traderListings, loadedFromOldLoc);
+	}
+
+	//! Server. Move entity storage files no listing JSON refers to anymore (e.g. left over from an interrupted listing or purchase)
+	//! to the trader's quarantine folder, so they can be restored by hand if the listing JSON was lost or damaged.
+	//! Only done if enabled in settings (QuarantineOrphanedEntityStorage).
+	protected int QuarantineOrphanedEntityStorage(int traderID)
+	{
+		#ifdef EXTRACE
+		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
+		#endif
+
+		string traderPath = GetP2PMarketDataDirectory() + "traderID_" + traderID + "\\";
+		string entityStoragePath = traderPath + "entitystorage\\";
+		if (!FileExist(entityStoragePath))
+			return 0;
+
+		int start = TickCount(0);
+		string listingsPath = traderPath + "listings\\";
+		string quarantinePath = traderPath + "entitystorage_quarantine\\";
+		string ext = ExpansionEntityStorageModule.EXT;
+		array<string> entityStorageFiles = ExpansionStatic.FindFilesInLocation(entityStoragePath, ext);
+		int moved;
+
+		foreach (string entityStorageFileName: entityStorageFiles)
 		{
-			foreach (string listingFileName: traderListings)
-			{
-				string filePath = (traderListingsPath + listingFileName);
-				if (!FileExist(filePath))
-				{
-					EXError.Error(this, "::LoadP2PMarketTraderData - Could not find and load P2P trader listing file=" + filePath);
-					continue;
-				}
+			string baseName = entityStorageFileName.Substring(0, entityStorageFileName.Length() - ext.Length());
+			if (FileExist(listingsPath + baseName + ".json"))
+				continue;
 
-				LoadListingData(traderID, listingFileName, traderListingsPath);
+			if (!FileExist(quarantinePath))
+				ExpansionStatic.MakeDirectoryRecursive(quarantinePath);
+
+			if (!CopyFile(entityStoragePath + entityStorageFileName, quarantinePath + entityStorageFileName) || !FileExist(quarantinePath + entityStorageFileName))
+			{
+				EXError.Error(this, "::QuarantineOrphanedEntityStorage - Could not move entity storage file " + entityStoragePath + entityStorageFileName + " to " + quarantinePath + ", keeping it");
+				continue;
 			}
+
+			EXError.Warn(this, "::QuarantineOrphanedEntityStorage - No listing for entity storage file " + entityStoragePath + entityStorageFileName + ", moved to " + quarantinePath);
+			DeleteFile(entityStoragePath + entityStorageFileName);
+			moved++;
 		}
-		
-		//! Delete old trader listings folder
-		if (loadedFromOldLoc)
-		{
-			ExpansionStatic.DeleteFiles(traderListingsPath, traderListings);
-			DeleteFile(traderListingsPath);
-		}
+
+		if (moved)
+			EXPrint(ToString() + "::QuarantineOrphanedEntityStorage - Trader ID " + traderID + ": Moved " + moved + " of " + entityStorageFiles.Count() + " entity storage files to quarantine in " + (TickCount(start) / 10000.0) + " ms");
+
+		return moved;
 	}
 
 	protected void LoadListingData(int traderID, string fileName, string path)
@@ -727,8 +770,10 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 				}
 
 				listings.Insert(listingData);
+				m_ListingIndex.Insert(listingData);
 				m_ListingsCount++;
-				counters.m_OwnedListingsCount++;
+				counters.OnListingAdded();
+				m_PriceIndex.OnListingAdded(listingData);
 
 				break;
 			}
@@ -743,8 +788,9 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 				}
 
 				listings.Insert(listingData);
-				counters.m_SoldListingsCount++;
-				counters.m_SoldTotalIncome += listingData.GetPrice();
+				m_SoldListingIndex.Insert(listingData);
+				counters.OnSaleAdded(listingData.GetPrice());
+				m_PriceIndex.OnListingSold(listingData);
 
 				break;
 			}
@@ -754,6 +800,9 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 				return;
 			}
 		}
+
+		//! Only the header stays resident, container items are reloaded on demand
+		listingData.UnloadBody();
 	}
 
 	// ------------------------------------------------------------------------------------------------------------------------
@@ -766,7 +815,14 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
 		#endif 
 		
-		m_TradingPlayers.Set(playerUID, traderID);
+		ExpansionP2PMarketTraderConfig traderConfig = GetP2PTraderConfigByID(traderID);
+		if (!traderConfig)
+		{
+			EXError.Error(this, "::AddTradingPlayer - Could not get P2P trader data for ID " + traderID);
+			return;
+		}
+
+		m_Subscriptions.Subscribe(playerUID, traderID, traderConfig.IsGlobalTrader());
 		
 		ExpansionP2PMarketCounters counters = GetPlayerDataCounters(playerUID);
 	}
@@ -794,9 +850,7 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		if (!ctx.Read(playerUID))
 			return;
 
-		int traderID;
-		if (m_TradingPlayers.Find(playerUID, traderID))
-			m_TradingPlayers.Remove(playerUID);
+		m_Subscriptions.Unsubscribe(playerUID);
 	}
 	
 	//! Client
@@ -840,6 +894,9 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			EXError.Error(this, "::RPC_RequestSaleFromListing - Could not get P2P trader data for ID " + traderID);
 			return;
 		}
+
+		if (!CheckInitialized(identity))
+			return;
 		
 		ExpansionP2PMarketListing listing = GetSoldListingByGlobalID(traderID, globalID, traderConfig.IsGlobalTrader());
 		string globalIDText = ExpansionStatic.IntToHex(globalID);
@@ -973,6 +1030,9 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			return;
 		}
 
+		if (!CheckInitialized(identity))
+			return;
+
 		map<int, ref array<ref ExpansionP2PMarketListing>> listingsData;
 		if (!traderConfig.IsGlobalTrader())
 		{
@@ -1001,7 +1061,7 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			for (int j = traderListings.Count() - 1; j >= 0; --j)
 			{
 				ExpansionP2PMarketListing listing = traderListings[j];
-				globalIDText = ExpansionStatic.IntToHex(listing.GetGlobalID());
+				globalIDText = listing.GetEntityStorageBaseName();
 				if (listing.GetListingState() == ExpansionP2PMarketListingState.SOLD && listing.GetOwnerUID() == playerUID)
 				{
 					sold++;
@@ -1035,50 +1095,160 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 	}
 	
 	//! Server
-	void SendUpdatedTraderData(ExpansionP2PMarketRequestData data, string senderUID)
+	//! Sends the callback to the sender and pushes the listing change only to players whose current page contains
+	//! the changed listing (removed) or would contain it (added and matching their query on a page that isn't full yet).
+	void SendUpdatedTraderData(ExpansionP2PMarketRequestData data, string senderUID, ExpansionP2PMarketListing listing, bool removed)
 	{
 		#ifdef EXTRACE
 		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
 		#endif
 
-		data.Debug();
-		
-		foreach (string playerUID, int id: m_TradingPlayers)
+		PlayerBase sender = PlayerBase.GetPlayerByUID(senderUID);
+		if (sender)
 		{
-			ErrorEx("Player UID: " + playerUID + " | Trader ID: " + id, ErrorExSeverity.INFO);		
-			ExpansionP2PMarketTraderConfig traderConfig = GetP2PTraderConfigByID(id);
-			if (!traderConfig)
+			Callback(sender.GetIdentity(), data.m_CallbackType, data.m_MessageTypeName, data.m_MessagePrice, data.m_MessagePriceString);
+			ListingDataChanged(sender.GetIdentity(), data.m_GlobalIDText);
+		}
+
+		int scanned;
+		int sent;
+
+		if (data.m_TraderID > -1)
+			SendListingDelta(m_Subscriptions.GetTraderSubscriptions(data.m_TraderID), senderUID, listing, removed, scanned, sent);
+
+		if (data.m_ListingTraderID > -1 && data.m_ListingTraderID != data.m_TraderID)
+			SendListingDelta(m_Subscriptions.GetTraderSubscriptions(data.m_ListingTraderID), senderUID, listing, removed, scanned, sent);
+
+		SendListingDelta(m_Subscriptions.GetGlobalSubscriptions(), senderUID, listing, removed, scanned, sent);
+
+		P2PDebugPrint("::SendUpdatedTraderData - Listing " + listing.GetEntityStorageBaseName() + " | Removed: " + removed + " | Viewers: " + m_Subscriptions.Count() + " | Scanned: " + scanned + " | Sent: " + sent);
+	}
+
+	//! Server
+	protected void SendListingDelta(map<string, ref ExpansionP2PMarketSubscription> subscriptions, string senderUID, ExpansionP2PMarketListing listing, bool removed, inout int scanned, inout int sent)
+	{
+		if (!subscriptions)
+			return;
+
+		string globalIDText = listing.GetEntityStorageBaseName();
+
+		TStringArray disconnected = {};
+
+		foreach (string playerUID, ExpansionP2PMarketSubscription subscription: subscriptions)
+		{
+			if (playerUID == senderUID)
+				continue;
+
+			scanned++;
+
+			if (!IsSubscriptionAffected(subscription, listing, globalIDText, removed))
+				continue;
+
+			PlayerBase player = PlayerBase.GetPlayerByUID(playerUID);
+			if (!player || !player.GetIdentity())
 			{
-				EXError.Error(this, "::SendUpdatedTraderData - Could not get P2P trader data for ID " + id);
-				return;
+				disconnected.Insert(playerUID);
+				continue;
 			}
 
-			if (traderConfig.IsGlobalTrader() || id == data.m_TraderID || data.m_ListingTraderID > -1 && id == data.m_ListingTraderID)
+			if (removed || subscription.m_SoldListings)
 			{
-				if (playerUID != senderUID)
-					data.m_CallbackType = ExpansionP2PMarketModuleCallback.Silent;
-				
-				PlayerBase player = PlayerBase.GetPlayerByUID(playerUID);
-				if (!player)
-					continue;
-				
-				if (playerUID == senderUID)
-				{
-					Callback(player.GetIdentity(), data.m_CallbackType, data.m_MessageTypeName, data.m_MessagePrice, data.m_MessagePriceString);
-				}
-	
-				ListingDataChanged(player.GetIdentity(), data.m_GlobalIDText);
-				ErrorEx("Send updated player data to player! Player UID: " + playerUID + " | Trader ID: " + id, ErrorExSeverity.INFO);
+				//! Client removes the listing from its page and requests the page again only if it needs to be refilled
+				ListingDataChanged(player.GetIdentity(), globalIDText);
+			}
+			else if (subscription.IsPageFull(LISTINGS_PER_PAGE_COUNT))
+			{
+				//! New listing ranks inside a full sorted page and pushes the last listing off it,
+				//! client drops that one and requests the page again
+				ListingDataChanged(player.GetIdentity(), subscription.m_PageGlobalIDs[subscription.m_PageGlobalIDs.Count() - 1]);
 			}
-			#ifdef DIAG_DEVELOPER
 			else
 			{
-				ErrorEx("Skipped sending updated player data to player! Player UID: " + playerUID + " | Trader ID: " + id, ErrorExSeverity.INFO);
+				auto rpc = Expansion_CreateRPC("RPC_SendListingAdded");
+				listing.OnSendBasic(rpc);
+				rpc.Expansion_Send(true, player.GetIdentity());
+
+				subscription.m_PageGlobalIDs.Insert(globalIDText);
 			}
-			#endif
+
+			sent++;
+		}
+
+		foreach (string disconnectedUID: disconnected)
+		{
+			m_Subscriptions.Unsubscribe(disconnectedUID);
 		}
 	}
+
+	//! Server
+	protected bool IsSubscriptionAffected(ExpansionP2PMarketSubscription subscription, ExpansionP2PMarketListing listing, string globalIDText, bool removed)
+	{
+		//! Sold listings only change for the owner of the listing
+		if (subscription.m_SoldListings)
+			return removed && listing.GetOwnerUID() == subscription.m_PlayerUID;
+
+		if (removed)
+			return subscription.IsOnPage(globalIDText);
+
+		//! New listings are appended to the end of unsorted queries, so they can only show up on a page that isn't full yet
+		if (!subscription.IsSorted() && subscription.IsPageFull(LISTINGS_PER_PAGE_COUNT))
+			return false;
+
+		if (subscription.m_OwnedListings && listing.GetOwnerUID() != subscription.m_PlayerUID)
+			return false;
+
+		if (subscription.m_CategoryIndex > -1 && listing.GetCategoryIndex() != subscription.m_CategoryIndex)
+			return false;
+
+		if (subscription.m_SubCategoryIndex > -1 && listing.GetSubCategoryIndex() != subscription.m_SubCategoryIndex)
+			return false;
+
+		if (subscription.m_SearchTypeNames.Count() > 0 && !IsValidSearchListing(subscription.m_SearchTypeNames, listing))
+			return false;
+
+		if (subscription.IsSorted())
+			return IsOnSortedPage(subscription, listing);
+
+		return true;
+	}
+
+	//! Server
+	//! Listing ranks inside the page range of the sorted view the subscription was served from
+	protected bool IsOnSortedPage(ExpansionP2PMarketSubscription subscription, ExpansionP2PMarketListing listing)
+	{
+		int viewTraderID = subscription.m_TraderID;
+		if (subscription.m_IsGlobal)
+			viewTraderID = -1;
+
+		ExpansionP2PMarketSortedView view = m_SortedViews.Find(viewTraderID, subscription.m_CategoryIndex, subscription.m_SubCategoryIndex, subscription.m_SortKey);
+		if (!view)
+			return false;
+
+		int rank = view.GetRank(listing, subscription.m_SortReverse);
+		int start = subscription.m_PageIndex * LISTINGS_PER_PAGE_COUNT;
+
+		return rank >= start && rank < start + LISTINGS_PER_PAGE_COUNT;
+	}
+
+	//! Server
+	protected void UpdateSubscription(PlayerIdentity identity, ExpansionP2PMarketRequestData data, bool soldListings, array<ref ExpansionP2PMarketListing> listingsToSend)
+	{
+		ExpansionP2PMarketSubscription subscription = m_Subscriptions.Get(identity.GetId());
+		if (!subscription || subscription.m_TraderID != data.m_TraderID)
+			return;
+
+		subscription.SetQuery(data, soldListings);
+		subscription.SetPage(listingsToSend);
+	}
 	
+	//! Client
+	//! Sort order used for all following listing requests
+	void SetListingsSort(ExpansionP2PMarketListingSortKey sortKey, bool reverse = false)
+	{
+		m_ListingsSortKey = sortKey;
+		m_ListingsSortReverse = reverse;
+	}
+
 	//! Client
 	void RequestBasicListingData(int traderID, int pageIndex, bool soldListings, int categoryIndex = -1, int subCategoryIndex = -1, array<string> searchTypeNames = null, bool ownedListings = false)
 	{
@@ -1094,6 +1264,10 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		rpc.Write(subCategoryIndex);
 		rpc.Write(searchTypeNames);
 		rpc.Write(ownedListings);
+		rpc.Write(m_CategoryListingsEpoch);
+		rpc.Write(m_CategoryListingsVersions.Get(traderID));
+		rpc.Write(m_ListingsSortKey);
+		rpc.Write(m_ListingsSortReverse);
 		rpc.Expansion_Send(true);
 	}
 	
@@ -1152,6 +1326,38 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			EXError.Error(this, "::RPC_RequestBasicListingData - Couldn't read owned listings bolean!");
 			return;
 		}
+		
+		int categoryListingsEpoch;
+		if (!ctx.Read(categoryListingsEpoch))
+		{
+			EXError.Error(this, "::RPC_RequestBasicListingData - Couldn't read category listings epoch!");
+			return;
+		}
+
+		int categoryListingsVersion;
+		if (!ctx.Read(categoryListingsVersion))
+		{
+			EXError.Error(this, "::RPC_RequestBasicListingData - Couldn't read category listings version!");
+			return;
+		}
+
+		//! Version was received before a server restart, client needs all counts again
+		if (categoryListingsEpoch != m_CategoryListingsEpoch)
+			categoryListingsVersion = 0;
+
+		ExpansionP2PMarketListingSortKey sortKey;
+		if (!ctx.Read(sortKey))
+		{
+			EXError.Error(this, "::RPC_RequestBasicListingData - Couldn't read sort key!");
+			return;
+		}
+
+		bool sortReverse;
+		if (!ctx.Read(sortReverse))
+		{
+			EXError.Error(this, "::RPC_RequestBasicListingData - Couldn't read sort order!");
+			return;
+		}
 
 		ExpansionP2PMarketRequestData data = new ExpansionP2PMarketRequestData();
 		data.m_TraderID = traderID;
@@ -1160,8 +1366,10 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		data.m_SubCategoryIndex = subCategoryIndex;
 		data.m_SearchTypeNames = searchTypeNames;
 		data.m_OwnedListings = ownedListings;
+		data.m_SortKey = sortKey;
+		data.m_SortReverse = sortReverse;
 		
-		SendCategoryListingsData(traderID, identity);
+		SendCategoryListingsData(traderID, identity, categoryListingsVersion);
 		
 		if (!soldListings)
 		{
@@ -1174,7 +1382,8 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 	}
 	
 	//! Server
-	void SendCategoryListingsData(int traderID, PlayerIdentity identity)
+	//! Sends all category listing counts, or only the counts that changed since `clientVersion` if the client already has them.
+	void SendCategoryListingsData(int traderID, PlayerIdentity identity, int clientVersion = 0)
 	{
 		#ifdef EXTRACE
 		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
@@ -1186,6 +1395,10 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			EXError.Error(this, "::SendCategoryListingsData - Could not get P2P trader data for ID " + traderID);
 			return;
 		}
+
+		//! Counts are sent once the trader is ready, SendBasicListingData tells the player to try again
+		if (!IsTraderReady(traderConfig))
+			return;
 		
 		bool isGlobal = traderConfig.IsGlobalTrader();
 		map<int, ref array<ref ExpansionP2PMarketCategoryListings>> dataMap;
@@ -1204,9 +1417,40 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			return;
 		}
 		
+		bool isDelta = clientVersion > 0 && clientVersion <= m_CategoryListingsVersion;
+		if (isDelta && clientVersion == m_CategoryListingsVersion)
+			return;  //! Client is up to date
+		
 		auto rpc = Expansion_CreateRPC("RPC_SendCategoryListingsData");
 		rpc.Write(traderID);
 		rpc.Write(isGlobal);
+		rpc.Write(m_CategoryListingsEpoch);
+		rpc.Write(m_CategoryListingsVersion);
+		rpc.Write(isDelta);
+		
+		if (isDelta)
+		{
+			array<ExpansionP2PMarketCategoryListings> changed = {};
+			foreach (int changedIndex, array<ref ExpansionP2PMarketCategoryListings> changedArray: dataMap)
+			{
+				foreach (ExpansionP2PMarketCategoryListings changedData: changedArray)
+				{
+					if (changedData.m_Version > clientVersion)
+						changed.Insert(changedData);
+				}
+			}
+			
+			int changedCount = changed.Count();
+			rpc.Write(changedCount);
+			foreach (ExpansionP2PMarketCategoryListings delta: changed)
+			{
+				delta.OnSend(rpc);
+			}
+			
+			rpc.Expansion_Send(true, identity);
+			return;
+		}
+		
 		int mapCount = dataMap.Count();
 		rpc.Write(mapCount);
 		
@@ -1245,6 +1489,62 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			return;
 		}
 
+		int epoch;
+		if (!ctx.Read(epoch))
+		{
+			EXError.Error(this, "::RPC_SendCategoryListingsData - Couldn't read epoch!");
+			return;
+		}
+
+		int version;
+		if (!ctx.Read(version))
+		{
+			EXError.Error(this, "::RPC_SendCategoryListingsData - Couldn't read version!");
+			return;
+		}
+
+		bool isDelta;
+		if (!ctx.Read(isDelta))
+		{
+			EXError.Error(this, "::RPC_SendCategoryListingsData - Couldn't read delta boolean!");
+			return;
+		}
+
+		//! Server restarted, versions of other traders are from the previous epoch
+		if (epoch != m_CategoryListingsEpoch)
+		{
+			m_CategoryListingsVersions.Clear();
+			m_CategoryListingsEpoch = epoch;
+		}
+
+		m_CategoryListingsVersions.Set(traderID, version);
+
+		if (isDelta)
+		{
+			int changedCount;
+			if (!ctx.Read(changedCount))
+			{
+				EXError.Error(this, "::RPC_SendCategoryListingsData - Couldn't read changed count!");
+				return;
+			}
+
+			ExpansionP2PMarketCategoryListings delta = new ExpansionP2PMarketCategoryListings();
+			for (int n = 0; n < changedCount; ++n)
+			{
+				if (!delta.OnRecieve(ctx))
+				{
+					EXError.Error(this, "::RPC_SendCategoryListingsData - Couldn't read changed ExpansionP2PMarketCategoryListings data!");
+					return;
+				}
+
+				ExpansionP2PMarketCategoryListings current = GetCategoryListingsData(delta.m_CategoryIndex, delta.m_SubCategoryIndex, traderID, isGlobal);
+				if (current)
+					current.m_Count = delta.m_Count;
+			}
+
+			return;
+		}
+
 		int mapCount;
 		if (!ctx.Read(mapCount))
 		{
@@ -1322,20 +1622,13 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 	{
 		string classNameLower;
 		bool hasChildWithName, hasName;
-		array<ref ExpansionP2PMarketContainerItem> containerItems = listing.GetContainerItems();
-		if (containerItems && containerItems.Count() > 0)
+		//! Resident type names, doesn't need the listing body
+		foreach (string containerTypeName: listing.GetContainerTypeNames())
 		{
-			for (int i = 0; i < containerItems.Count(); ++i)
+			foreach(int index, string cTN: searchTypeNames)
 			{
-				ExpansionP2PMarketContainerItem containerItem = containerItems[i];
-				classNameLower = containerItem.GetClassName();
-				classNameLower.ToLower();
-
-				foreach(int index, string cTN: searchTypeNames)
-				{
-					if (classNameLower.IndexOf(cTN) > -1)
-						hasChildWithName = true;
-				}
+				if (containerTypeName.IndexOf(cTN) > -1)
+					hasChildWithName = true;
 			}
 		}
 
@@ -1366,6 +1659,9 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 	        EXError.Error(this, "::SendBasicListingData - Could not get P2P trader data for ID " + data.m_TraderID);
 	        return;
 	    }
+
+	    if (!CheckInitialized(identity))
+	        return;
 	
 	    ExpansionP2PMarketCounters counters;
 	    m_PlayerDataCounters.Find(identity.GetId(), counters);
@@ -1381,68 +1677,82 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 	    
 		int listingStartIndex = data.m_PageIndex * LISTINGS_PER_PAGE_COUNT; // Where to start fetching listings
 		int listingsCount = 0; // Tracks how many valid listings we've considered so far
-		int traderListingsCount = 0;
-		int validListingsCount = 0;
-	
-	    P2PDebugPrint("Listing start index: " + listingStartIndex);
-	    
-	    //! Iterate through all available listings and collect the next 14 based on conditions
-	    foreach (int traderID, array<ref ExpansionP2PMarketListing> listingData: m_ListingsData)
-	    {
-	        P2PDebugPrint("Trader ID: " + traderID + " | Listings count: " + listingData.Count());	
-	        if (!isGlobal && traderID != data.m_TraderID)
-	            continue; // Skip traders that aren't the requested trader
-	
-	        if (traderID == data.m_TraderID)
-	            traderListingsCount = listingData.Count();
-	
-	        // Loop through the trader's listings and filter them
-	        for (int i = 0; i < listingData.Count(); ++i)
-	        {
-	            ExpansionP2PMarketListing listing = listingData[i];
+		int traderListingsCount = 0;
+		int validListingsCount = 0;
 	
-	            // Skip invalid listings
-	            if (!listing)
-	            {
-					P2PDebugPrint("[S1] - Skipping listing: " + listing.GetClassName() + " | Current count: " + listingsCount + " | Start index: " + listingStartIndex);
-	                continue;
-	            }
+	    P2PDebugPrint("Listing start index: " + listingStartIndex);
 
-				if (data.m_OwnedListings && listing.GetOwnerUID() != identity.GetId())
-				{
-					P2PDebugPrint("[S2] - Skipping listing: " + listing.GetClassName() + " | Current count: " + listingsCount + " | Start index: " + listingStartIndex);
-					continue;
-				}
+	    ExpansionP2PMarketSortedView sortedView = GetSortedView(data, isGlobal);
+	    if (sortedView)
+	    {
+	        //! Sorted page in global order, sliced by rank
+	        validListingsCount = sortedView.Count();
+	        sortedView.GetPage(listingStartIndex, LISTINGS_PER_PAGE_COUNT, data.m_SortReverse, listingsToSend);
 
-				if ((data.m_CategoryIndex > -1 && listing.GetCategoryIndex() != data.m_CategoryIndex) || (data.m_SubCategoryIndex > -1 && listing.GetSubCategoryIndex() != data.m_SubCategoryIndex))
-				{
-					P2PDebugPrint("[S3] - Skipping listing: " + listing.GetClassName() + " | Current count: " + listingsCount + " | Start index: " + listingStartIndex);
-					continue;
-				}
+	        array<ref ExpansionP2PMarketListing> traderListings = m_ListingsData[data.m_TraderID];
+	        if (traderListings)
+	            traderListingsCount = traderListings.Count();
+	    }
+	    else
+	    {
+		    //! Iterate through all available listings and collect the next 14 based on conditions
+		    foreach (int traderID, array<ref ExpansionP2PMarketListing> listingData: m_ListingsData)
+		    {
+		        P2PDebugPrint("Trader ID: " + traderID + " | Listings count: " + listingData.Count());	
+		        if (!isGlobal && traderID != data.m_TraderID)
+		            continue; // Skip traders that aren't the requested trader
+	
+		        if (traderID == data.m_TraderID)
+		            traderListingsCount = listingData.Count();
+	
+		        // Loop through the trader's listings and filter them
+		        for (int i = 0; i < listingData.Count(); ++i)
+		        {
+		            ExpansionP2PMarketListing listing = listingData[i];
+	
+		            // Skip invalid listings
+		            if (!listing)
+		            {
+						P2PDebugPrint("[S1] - Skipping listing: " + listing.GetClassName() + " | Current count: " + listingsCount + " | Start index: " + listingStartIndex);
+		                continue;
+		            }
+
+					if (data.m_OwnedListings && listing.GetOwnerUID() != identity.GetId())
+					{
+						P2PDebugPrint("[S2] - Skipping listing: " + listing.GetClassName() + " | Current count: " + listingsCount + " | Start index: " + listingStartIndex);
+						continue;
+					}
 
-				if ((data.m_SearchTypeNames.Count() > 0 && !IsValidSearchListing(data.m_SearchTypeNames, listing)))
-	            {
-					P2PDebugPrint("[S4] - Skipping listing: " + listing.GetClassName() + " | Current count: " + listingsCount + " | Start index: " + listingStartIndex);
-	                continue;
-	            }
+					if ((data.m_CategoryIndex > -1 && listing.GetCategoryIndex() != data.m_CategoryIndex) || (data.m_SubCategoryIndex > -1 && listing.GetSubCategoryIndex() != data.m_SubCategoryIndex))
+					{
+						P2PDebugPrint("[S3] - Skipping listing: " + listing.GetClassName() + " | Current count: " + listingsCount + " | Start index: " + listingStartIndex);
+						continue;
+					}
+
+					if ((data.m_SearchTypeNames.Count() > 0 && !IsValidSearchListing(data.m_SearchTypeNames, listing)))
+		            {
+						P2PDebugPrint("[S4] - Skipping listing: " + listing.GetClassName() + " | Current count: " + listingsCount + " | Start index: " + listingStartIndex);
+		                continue;
+		            }
 				
-				validListingsCount++;
+					validListingsCount++;
 				
-	            // Only count valid listings
-	            if (listingsCount < listingStartIndex)
-	            {
-					P2PDebugPrint("[S5] - Skipping listing: " + listing.GetClassName() + " | Current count: " + listingsCount + " | Start index: " + listingStartIndex);
-	                listingsCount++;
-	                continue; // Skip listings from previous pages
-	            }
-	
-	            // Add valid listings to the response
-	            if (listingsToSend.Find(listing) == -1 && listingsToSend.Count() < LISTINGS_PER_PAGE_COUNT)
-	            {
-					P2PDebugPrint("Send listing: " + listing + " | Item: " + listing.GetClassName() + " | Current listings count: " + listingsCount);
-	                listingsToSend.Insert(listing);
-	            }
-	        }
+		            // Only count valid listings
+		            if (listingsCount < listingStartIndex)
+		            {
+						P2PDebugPrint("[S5] - Skipping listing: " + listing.GetClassName() + " | Current count: " + listingsCount + " | Start index: " + listingStartIndex);
+		                listingsCount++;
+		                continue; // Skip listings from previous pages
+		            }
+	
+		            // Add valid listings to the response
+		            if (listingsToSend.Find(listing) == -1 && listingsToSend.Count() < LISTINGS_PER_PAGE_COUNT)
+		            {
+						P2PDebugPrint("Send listing: " + listing + " | Item: " + listing.GetClassName() + " | Current listings count: " + listingsCount);
+		                listingsToSend.Insert(listing);
+		            }
+		        }
+		    }
 	    }
 		
 		int currentTotalListings;
@@ -1489,8 +1799,24 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 	    }
 	
 	    rpc.Expansion_Send(true, identity);
+
+	    UpdateSubscription(identity, data, false, listingsToSend);
 	}
 	
+	//! Server
+	//! Returns sorted view for the query, NULL if the query isn't sorted or filters by owner or search terms (those pages are collected by scanning)
+	protected ExpansionP2PMarketSortedView GetSortedView(ExpansionP2PMarketRequestData data, bool isGlobal)
+	{
+		if (data.m_SortKey == ExpansionP2PMarketListingSortKey.NONE || data.m_OwnedListings || data.m_SearchTypeNames.Count() > 0)
+			return null;
+
+		int viewTraderID = data.m_TraderID;
+		if (isGlobal)
+			viewTraderID = -1;
+
+		return m_SortedViews.Get(viewTraderID, data.m_CategoryIndex, data.m_SubCategoryIndex, data.m_SortKey, m_ListingsData);
+	}
+
 	//! Server	
 	void SendBasicSoldListingData(ExpansionP2PMarketRequestData data, PlayerIdentity identity)
 	{
@@ -1506,6 +1832,9 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 	        EXError.Error(this, "::SendBasicSoldListingData - Could not get P2P trader data for ID " + data.m_TraderID);
 	        return;
 	    }
+
+	    if (!CheckInitialized(identity))
+	        return;
 	
 	    ExpansionP2PMarketCounters counters;
 	    m_PlayerDataCounters.Find(identity.GetId(), counters);
@@ -1607,6 +1936,8 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		}
 
 		rpc.Expansion_Send(true, identity);
+
+		UpdateSubscription(identity, data, true, listingsToSend);
 	}
 	
 	//! Check if given page index is not to high after receiving a silent update and the page the player is currently on in the menu is not valid anymore because the amount of pages has changed (e.g., listing was brought).
@@ -1896,6 +2227,9 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			return;
 		}
 
+		if (!CheckInitialized(identity))
+			return;
+
 		if (!CanListItem(identity, target, price))
 		{
 			EXError.Error(this, "::RPC_RequestListItem - Listing conditions failed!");
@@ -2058,6 +2392,9 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			EXError.Error(this, "::ListItem - Could not get P2P trader data for ID " + traderID);
 			return;
 		}
+
+		if (!CheckInitialized(identity))
+			return;
 		
 		ExpansionP2PMarketListing newListing = new ExpansionP2PMarketListing();
 		newListing.SetFromItem(objEntity, player);
@@ -2109,6 +2446,7 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		newListing.Save();
 		
 		UpdateListingCategoryData(newListing, false); //! Update global/trader p2p market category data
+		m_SortedViews.Insert(newListing);
 
 		ExpansionP2PMarketRequestData data = new ExpansionP2PMarketRequestData();
 		data.m_TraderID = traderID;
@@ -2116,11 +2454,11 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		data.m_MessageTypeName = type;
 		data.m_MessagePrice = price;
 
-		SendUpdatedTraderData(data, identity.GetId()); //! Update listing data for all trading players at the same trader.
+		SendUpdatedTraderData(data, identity.GetId(), newListing, false); //! Update listing data for all trading players at the same trader.
 
 		if (GetExpansionSettings().GetLog().Market)
 		{
-			string globalIDText = ExpansionStatic.IntToHex(newListing.GetGlobalID());
+			string globalIDText = newListing.GetEntityStorageBaseName();
 			string priceStringLog = string.Format("%1 (%2)", price, GetDisplayPrice(traderConfig, price, false, false, true));
 			GetExpansionSettings().GetLog().PrintLog("[P2P Market] Player \"" + identity.GetName() + "\" (id=" + identity.GetId() + ")" + " has listed \"" + newListing.GetClassName() + "\" for a price of " + priceStringLog + " (globalID=" + globalIDText + ")");
 		}
@@ -2133,6 +2471,7 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		#endif
 		
 		ExpansionP2PMarketCounters counters = GetPlayerDataCounters(listing.GetOwnerUID());
+		listing.CacheBody();
 		
 		array<ref ExpansionP2PMarketListing> listings;
 		if (m_ListingsData.Find(traderID, listings))
@@ -2140,8 +2479,10 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			if (listings.Find(listing) == -1)
 			{
 				listings.Insert(listing);
+				m_ListingIndex.Insert(listing);
 				m_ListingsCount++;
-				counters.m_OwnedListingsCount++;
+				counters.OnListingAdded();
+				m_PriceIndex.OnListingAdded(listing);
 			}
 		}
 		else
@@ -2149,8 +2490,10 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			listings = new array<ref ExpansionP2PMarketListing>;
 			listings.Insert(listing);
 			m_ListingsData.Insert(traderID, listings);
+			m_ListingIndex.Insert(listing);
 			m_ListingsCount++;
-			counters.m_OwnedListingsCount++;
+			counters.OnListingAdded();
+			m_PriceIndex.OnListingAdded(listing);
 		}
 	}
 	
@@ -2160,12 +2503,18 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
 		#endif
 
+		ExpansionP2PMarketCounters counters = GetPlayerDataCounters(listing.GetOwnerUID());
+		listing.CacheBody();
+
 		array<ref ExpansionP2PMarketListing> listings;
 		if (m_SoldListingsData.Find(traderID, listings))
 		{
 			if (listings.Find(listing) == -1)
 			{
 				listings.Insert(listing);
+				m_SoldListingIndex.Insert(listing);
+				counters.OnSaleAdded(listing.GetPrice());
+				m_PriceIndex.OnListingSold(listing);
 			}
 		}
 		else
@@ -2173,6 +2522,9 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			listings = new array<ref ExpansionP2PMarketListing>;
 			listings.Insert(listing);
 			m_SoldListingsData.Insert(traderID, listings);
+			m_SoldListingIndex.Insert(listing);
+			counters.OnSaleAdded(listing.GetPrice());
+			m_PriceIndex.OnListingSold(listing);
 		}
 	}
 	
@@ -2229,6 +2581,26 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		m_UpdateInvoker.Invoke(globalIDText);
 	}
 
+	//!Client
+	protected void RPC_SendListingAdded(PlayerIdentity identity, Object target, ParamsReadContext ctx)
+	{
+		#ifdef EXTRACE
+		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
+		#endif
+
+		if (!GetDayZGame().GetExpansionGame().GetExpansionUIManager().GetMenu())
+			return;
+
+		ExpansionP2PMarketListing listing = new ExpansionP2PMarketListing();
+		if (!listing.OnRecieveBasic(ctx))
+		{
+			EXError.Error(this, "::RPC_SendListingAdded - Couldn't receive listing");
+			return;
+		}
+
+		m_ListingAddedInvoker.Invoke(listing);
+	}
+
 	//!Client
 	void RequestListingDetails(int traderID, TIntArray globalID)
 	{
@@ -2271,6 +2643,9 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			EXError.Error(this, "::RPC_RequestListingDetails - Could not get P2P trader data for ID " + traderID);
 			return;
 		}
+
+		if (!CheckTraderReady(traderConfig, identity))
+			return;
 		
 		ExpansionP2PMarketListing listingToSend = GetListingByGlobalID(traderID, globalID, traderConfig.IsGlobalTrader());
 		if (!listingToSend)
@@ -2301,6 +2676,80 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		
 		m_ListingDetailsInvoker.Invoke(listing);
 	}
+
+	//! Client
+	void RequestPriceRange(int traderID, string className)
+	{
+		#ifdef EXTRACE
+		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
+		#endif
+
+		auto rpc = Expansion_CreateRPC("RPC_RequestPriceRange");
+		rpc.Write(traderID);
+		rpc.Write(className);
+		rpc.Expansion_Send(true);
+	}
+
+	//! Server
+	protected void RPC_RequestPriceRange(PlayerIdentity identity, Object target, ParamsReadContext ctx)
+	{
+		#ifdef EXTRACE
+		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
+		#endif
+
+		int traderID;
+		if (!ctx.Read(traderID))
+		{
+			EXError.Error(this, "::RPC_RequestPriceRange - Could not read trader ID.");
+			return;
+		}
+
+		string className;
+		if (!ctx.Read(className))
+		{
+			EXError.Error(this, "::RPC_RequestPriceRange - Could not read class name.");
+			return;
+		}
+
+		ExpansionP2PMarketTraderConfig traderConfig = GetP2PTraderConfigByID(traderID);
+		if (!traderConfig)
+		{
+			EXError.Error(this, "::RPC_RequestPriceRange - Could not get P2P trader data for ID " + traderID);
+			return;
+		}
+
+		if (!CheckTraderReady(traderConfig, identity))
+			return;
+
+		//! Global traders show listings of all traders
+		int rangeTraderID = traderID;
+		if (traderConfig.IsGlobalTrader())
+			rangeTraderID = -1;
+
+		ExpansionP2PMarketPriceRange range = m_PriceIndex.GetRange(rangeTraderID, className);
+		range.m_TraderID = traderID;
+
+		auto rpc = Expansion_CreateRPC("RPC_SendPriceRange");
+		range.OnSend(rpc);
+		rpc.Expansion_Send(true, identity);
+	}
+
+	//! Client
+	protected void RPC_SendPriceRange(PlayerIdentity identity, Object target, ParamsReadContext ctx)
+	{
+		#ifdef EXTRACE
+		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
+		#endif
+
+		ExpansionP2PMarketPriceRange range = new ExpansionP2PMarketPriceRange();
+		if (!range.OnRecieve(ctx))
+		{
+			EXError.Error(this, "::RPC_SendPriceRange - Could not read price range!");
+			return;
+		}
+
+		m_PriceRangeInvoker.Invoke(range);
+	}
 	
 	//! Client
 	void RequestPurchaseItem(int traderID, ExpansionP2PMarketListing listing, int pageIndex, int categoryIndex, int subCategoryIndex, bool ownedListings)
@@ -2402,6 +2851,9 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			return;
 		}
 
+		if (!CheckInitialized(identity))
+			return;
+
 		ExpansionP2PMarketListing listing = GetListingByGlobalID(listingTraderID, globalID, traderConfig.IsGlobalTrader());
 		if (!listing)
 		{
@@ -2427,8 +2879,6 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			return;
 		}
 		
-		ExpansionP2PMarketCounters counters = GetPlayerDataCounters(listing.GetOwnerUID());
-
 		bool isOwner;
 		if (listingOwnerUID == playerUID)
 			isOwner = true;
@@ -2562,10 +3012,6 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			soldListing.Save();
 			
 			AddSoldListing(listingTraderID, soldListing);
-			
-			counters.m_SoldListingsCount++;
-			counters.m_SoldTotalIncome += listing.GetPrice();
-			counters.m_OwnedListingsCount--;
 		}
 		else
 		{
@@ -2576,8 +3022,6 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 				EXError.Error(this, "::RPC_RequestPurchaseItem - Could not remove listing " + globalIDText);
 				ExpansionNotification("RPC_RequestPurchaseItem", "Could not remove listing " + globalIDText).Error(identity);
 			}
-
-			counters.m_OwnedListingsCount--;
 		}
 
 		int messagePrice;
@@ -2602,7 +3046,7 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		data.m_MessagePrice = messagePrice;
 		data.m_GlobalIDText = globalIDText;
 		
-		SendUpdatedTraderData(data, identity.GetId());
+		SendUpdatedTraderData(data, identity.GetId(), listing, true);
 		
 		if (!isOwner)
 		{
@@ -2868,6 +3312,16 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		return m_UpdateInvoker;
 	}
 
+	ScriptInvoker GetListingAddedSI()
+	{
+		return m_ListingAddedInvoker;
+	}
+
+	ScriptInvoker GetPriceRangeSI()
+	{
+		return m_PriceRangeInvoker;
+	}
+
 	static int GetDiscountPrice(int price)
 	{
 		#ifdef EXTRACE
@@ -2937,17 +3391,84 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
 		#endif 
 		
-		int count;
+		ExpansionP2PMarketCounters counters;
+		if (!m_PlayerDataCounters.Find(playerUID, counters))
+			return 0;
+
+		return counters.m_OwnedListingsCount;
+	}
+
+	//! Server
+	//! Recounts all player counters from the listings, logs and corrects counters that drifted. Returns number of drifted players.
+	int AuditPlayerDataCounters()
+	{
+		#ifdef EXTRACE
+		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
+		#endif
+
+		int start = TickCount(0);
+
+		map<string, ref ExpansionP2PMarketCounters> recount = new map<string, ref ExpansionP2PMarketCounters>;
+		ExpansionP2PMarketCounters counters;
+
 		foreach (int traderID, array<ref ExpansionP2PMarketListing> listings: m_ListingsData)
 		{
 			foreach (ExpansionP2PMarketListing listing: listings)
 			{
-				if (listing.GetOwnerUID() == playerUID)
-					count++;
+				if (!recount.Find(listing.GetOwnerUID(), counters))
+				{
+					counters = new ExpansionP2PMarketCounters();
+					recount.Insert(listing.GetOwnerUID(), counters);
+				}
+
+				counters.OnListingAdded();
+			}
+		}
+
+		foreach (int soldTraderID, array<ref ExpansionP2PMarketListing> soldListings: m_SoldListingsData)
+		{
+			foreach (ExpansionP2PMarketListing soldListing: soldListings)
+			{
+				if (!recount.Find(soldListing.GetOwnerUID(), counters))
+				{
+					counters = new ExpansionP2PMarketCounters();
+					recount.Insert(soldListing.GetOwnerUID(), counters);
+				}
+
+				counters.OnSaleAdded(soldListing.GetPrice());
 			}
 		}
 
-		return count;
+		int drifted;
+		ExpansionP2PMarketCounters empty = new ExpansionP2PMarketCounters();
+
+		foreach (string playerUID, ExpansionP2PMarketCounters current: m_PlayerDataCounters)
+		{
+			ExpansionP2PMarketCounters expected;
+			if (!recount.Find(playerUID, expected))
+				expected = empty;
+
+			if (current.IsEqual(expected))
+				continue;
+
+			EXError.Warn(this, "::AuditPlayerDataCounters - Counters of player " + playerUID + " drifted: " + current.ToDebugString() + ", expected " + expected.ToDebugString());
+			current.Copy(expected);
+			drifted++;
+		}
+
+		foreach (string recountUID, ExpansionP2PMarketCounters recounted: recount)
+		{
+			if (m_PlayerDataCounters.Contains(recountUID))
+				continue;
+
+			EXError.Warn(this, "::AuditPlayerDataCounters - Counters of player " + recountUID + " missing, expected " + recounted.ToDebugString());
+			m_PlayerDataCounters.Insert(recountUID, recounted);
+			drifted++;
+		}
+
+		EXPrint(ToString() + "::AuditPlayerDataCounters - Audited " + m_PlayerDataCounters.Count() + " players in " + (TickCount(start) / 10000.0) + " ms, " + drifted + " drifted");
+
+		return drifted;
 	}
 
 	ExpansionP2PMarketCategoryListings GetCategoryListingsData(int categoryIndex, int subCategoryIndex = -1, int traderID = -1, bool isGlobal = false)
@@ -2995,25 +3516,7 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
 		#endif
 		
-		string globalIDText = ExpansionStatic.IntToHex(globalID);
-		ExpansionP2PMarketListing listing;
-		if (traderID > -1 && !globalTrader)
-		{
-			array<ref ExpansionP2PMarketListing> listings = m_ListingsData[traderID];
-			if (listings)
-				listing = ExGetListingByGlobalID(listings, globalID);
-		}
-		else if (globalTrader)
-		{
-			foreach (int listingsTraderID, array<ref ExpansionP2PMarketListing> dataListing: m_ListingsData)
-			{
-				listing = ExGetListingByGlobalID(dataListing, globalID);
-				if (listing)
-					break;
-			}
-		}
-
-		return listing;
+		return ExGetListingByGlobalID(m_ListingIndex, traderID, globalID, globalTrader);
 	}
 	
 	protected ExpansionP2PMarketListing GetSoldListingByGlobalID(int traderID, TIntArray globalID, bool globalTrader = false)
@@ -3022,39 +3525,19 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
 		#endif
 		
-		string globalIDText = ExpansionStatic.IntToHex(globalID);
-		ExpansionP2PMarketListing listing;
-		if (traderID > -1 && !globalTrader)
-		{
-			array<ref ExpansionP2PMarketListing> listings = m_SoldListingsData[traderID];
-			if (listings)
-				listing = ExGetListingByGlobalID(listings, globalID);
-		}
-		else if (globalTrader)
-		{
-			foreach (int listingsTraderID, array<ref ExpansionP2PMarketListing> dataListing: m_SoldListingsData)
-			{
-				listing = ExGetListingByGlobalID(dataListing, globalID);
-				if (listing)
-					break;
-			}
-		}
-
-		return listing;
+		return ExGetListingByGlobalID(m_SoldListingIndex, traderID, globalID, globalTrader);
 	}
 
-	protected ExpansionP2PMarketListing ExGetListingByGlobalID(array<ref ExpansionP2PMarketListing> listings, TIntArray globalID)
+	protected ExpansionP2PMarketListing ExGetListingByGlobalID(ExpansionP2PMarketListingIndex index, int traderID, TIntArray globalID, bool globalTrader)
 	{
-		string globalIDText = ExpansionStatic.IntToHex(globalID);
-		foreach (ExpansionP2PMarketListing listing: listings)
-		{
-			bool isValid = listing.IsGlobalIDValid();
-			bool isEqual = listing.IsGlobalIDEqual(globalID);
-			string listingIDText = ExpansionStatic.IntToHex(listing.GetGlobalID());
+		if (globalTrader)
+			traderID = -1;
+		else if (traderID == -1)
+			return null;
 
-			if (isValid && isEqual)
-				return listing;
-		}
+		ExpansionP2PMarketListing listing = index.Get(traderID, new ExpansionP2PMarketGlobalID(globalID));
+		if (listing && listing.IsGlobalIDValid())
+			return listing;
 
 		return null;
 	}
@@ -3065,26 +3548,7 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
 		#endif 
 
-		if (traderID > -1 && !globalTrader)
-		{
-			array<ref ExpansionP2PMarketListing> listings = m_ListingsData[traderID];
-			if (listings && ExRemoveListingByGlobalID(listings, globalID, deleteEntityStorageFile, deleteJSONFile))
-			{
-				return true;
-			}
-		}
-		else
-		{
-			foreach (int listingsTraderID, array<ref ExpansionP2PMarketListing> dataListings: m_ListingsData)
-			{
-				if (ExRemoveListingByGlobalID(dataListings, globalID, deleteEntityStorageFile, deleteJSONFile))
-				{
-					return true;
-				}
-			}
-		}
-
-		return false;
+		return ExRemoveListingByGlobalID(m_ListingIndex, m_ListingsData, traderID, globalID, globalTrader, deleteEntityStorageFile, deleteJSONFile);
 	}
 
 	protected bool RemoveSoldListingByGlobalID(int traderID, TIntArray globalID, bool globalTrader = false, bool deleteEntityStorageFile = false, bool deleteJSONFile = false)
@@ -3093,50 +3557,31 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
 		#endif 
 		
-		if (traderID > -1 && !globalTrader)
-		{
-			array<ref ExpansionP2PMarketListing> listings = m_SoldListingsData[traderID];
-			if (listings && ExRemoveListingByGlobalID(listings, globalID, deleteEntityStorageFile, deleteJSONFile, true))
-			{
-				return true;
-			}
-		}
-		else
-		{
-			foreach (int listingsTraderID, array<ref ExpansionP2PMarketListing> dataListings: m_SoldListingsData)
-			{
-				if (ExRemoveListingByGlobalID(dataListings, globalID, deleteEntityStorageFile, deleteJSONFile, true))
-				{
-					return true;
-				}
-			}
-		}
-
-		return false;
+		return ExRemoveListingByGlobalID(m_SoldListingIndex, m_SoldListingsData, traderID, globalID, globalTrader, deleteEntityStorageFile, deleteJSONFile, true);
 	}
 	
-	protected bool ExRemoveListingByGlobalID(array<ref ExpansionP2PMarketListing> listings, TIntArray globalID, bool deleteEntityStorageFile = false, bool deleteJSONFile = false, bool soldListing = false)
+	protected bool ExRemoveListingByGlobalID(ExpansionP2PMarketListingIndex listingIndex, map<int, ref array<ref ExpansionP2PMarketListing>> listingsData, int traderID, TIntArray globalID, bool globalTrader = false, bool deleteEntityStorageFile = false, bool deleteJSONFile = false, bool soldListing = false)
 	{
 		#ifdef EXTRACE
 		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
 		#endif
 		
-		string globalIDText = ExpansionStatic.IntToHex(globalID);
-		for (int i = listings.Count() - 1; i >= 0; --i)
-		{
-			ExpansionP2PMarketListing listing = listings[i];
-			string listingIDText = ExpansionStatic.IntToHex(listing.GetGlobalID());
-			bool isValid = listing.IsGlobalIDValid();
-			bool isEqual = listing.IsGlobalIDEqual(globalID);
+		if (globalTrader)
+			traderID = -1;
 
-			if (isValid && isEqual)
-			{
-				if (RemoveListing(listing, listings, i, deleteEntityStorageFile, deleteJSONFile, soldListing))
-					return true;
-			}
-		}
+		ExpansionP2PMarketListing listing = listingIndex.Get(traderID, new ExpansionP2PMarketGlobalID(globalID));
+		if (!listing || !listing.IsGlobalIDValid())
+			return false;
 
-		return false;
+		array<ref ExpansionP2PMarketListing> listings = listingsData[listing.GetTraderID()];
+		if (!listings)
+			return false;
+
+		int index = listings.Find(listing);
+		if (index == -1)
+			return false;
+
+		return RemoveListing(listing, listings, index, deleteEntityStorageFile, deleteJSONFile, soldListing);
 	}
 
 	protected bool RemoveListing(notnull ExpansionP2PMarketListing listing, notnull array<ref ExpansionP2PMarketListing> listings, int index, bool deleteEntityStorageFile = false, bool deleteJSONFile = false, bool soldListing = false)
@@ -3186,6 +3631,19 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 			}
 		}
 
+		ExpansionP2PMarketListingBodyCache.Remove(listing);
+
+		if (!soldListing)
+		{
+			m_ListingIndex.Remove(listing);
+			m_SortedViews.Remove(listing);
+			m_PriceIndex.OnListingRemoved(listing);
+		}
+		else
+		{
+			m_SoldListingIndex.Remove(listing);
+		}
+
 		listings.RemoveOrdered(index);
 
 		if (listings.Count() == 0)
@@ -3206,13 +3664,12 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 
 		if (soldListing)
 		{
-			counters.m_SoldListingsCount--;
-			counters.m_SoldTotalIncome -= listing.GetPrice();
+			counters.OnSaleRemoved(listing.GetPrice());
 		}
 		else
 		{
 			m_ListingsCount--;
-			counters.m_OwnedListingsCount--;
+			counters.OnListingRemoved();
 		}
 		
 		return true;
@@ -3229,7 +3686,12 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		super.OnUpdate(sender, args);
 
 		if (!m_Initialized)
+		{
+			if (m_Loader)
+				UpdateLoader();
+
 			return;
+		}
 
 		auto update = CF_EventUpdateArgs.Cast(args);
 
@@ -3238,6 +3700,12 @@ class ExpansionP2PMarketModule: CF_ModuleWorld
 		{
 			CheckListingsTimes();
 			m_CheckListingsTime = 0.0;
+
+		#ifdef EXPANSIONMODP2PMARKET_DEBUG
+			m_PriceIndex.Audit(m_ListingsData);
+			AuditPlayerDataCounters();
+			EXPrint(ToString() + "::OnUpdate - Listing bodies " + ExpansionP2PMarketListingBodyCache.ToDebugString());
+		#endif
 		}
 	}
 	#endif
@@ -30,5 +30,6 @@ enum ExpansionP2PMarketModuleCallback
 	ErrorVehicleSpawnPositionBlocked,
 	ErrorVehicleLockpicked,
 	ErrorVehicleKeysMissing,
-	ErrorPersistency
+	ErrorPersistency,
+	ErrorWarmingUp
 };
\ No newline at end of file
@@ -0,0 +1,372 @@
+/**
+ * ExpansionP2PMarketPriceIndex.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2025 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+//! Server & Client. Price aggregates of one type name as sent to the client.
+class ExpansionP2PMarketPriceRange
+{
+	int m_TraderID = -1;
+	string m_ClassName;
+	int m_Count;
+	int m_Min;
+	int m_Max;
+	int m_Median;
+	int m_RecentSalesCount;
+	int m_RecentSalesVWAP;
+
+	void OnSend(ParamsWriteContext ctx)
+	{
+		ctx.Write(m_TraderID);
+		ctx.Write(m_ClassName);
+		ctx.Write(m_Count);
+		ctx.Write(m_Min);
+		ctx.Write(m_Max);
+		ctx.Write(m_Median);
+		ctx.Write(m_RecentSalesCount);
+		ctx.Write(m_RecentSalesVWAP);
+	}
+
+	bool OnRecieve(ParamsReadContext ctx)
+	{
+		if (!ctx.Read(m_TraderID))
+		{
+			Error(ToString() + "::OnRecieve - m_TraderID");
+			return false;
+		}
+
+		if (!ctx.Read(m_ClassName))
+		{
+			Error(ToString() + "::OnRecieve - m_ClassName");
+			return false;
+		}
+
+		if (!ctx.Read(m_Count))
+		{
+			Error(ToString() + "::OnRecieve - m_Count");
+			return false;
+		}
+
+		if (!ctx.Read(m_Min))
+		{
+			Error(ToString() + "::OnRecieve - m_Min");
+			return false;
+		}
+
+		if (!ctx.Read(m_Max))
+		{
+			Error(ToString() + "::OnRecieve - m_Max");
+			return false;
+		}
+
+		if (!ctx.Read(m_Median))
+		{
+			Error(ToString() + "::OnRecieve - m_Median");
+			return false;
+		}
+
+		if (!ctx.Read(m_RecentSalesCount))
+		{
+			Error(ToString() + "::OnRecieve - m_RecentSalesCount");
+			return false;
+		}
+
+		if (!ctx.Read(m_RecentSalesVWAP))
+		{
+			Error(ToString() + "::OnRecieve - m_RecentSalesVWAP");
+			return false;
+		}
+
+		return true;
+	}
+}
+
+//! Server. Listed prices of one type name kept as a sorted multiset (min, max and median are O(1), insert and remove
+//! binary search their position) plus the most recent sales ordered by sale time.
+class ExpansionP2PMarketPriceStats
+{
+	static const int RECENT_SALES_COUNT = 20;
+
+	protected ref TIntArray m_Prices = new TIntArray;
+	protected ref TIntArray m_SaleTimes = new TIntArray;
+	protected ref TIntArray m_SalePrices = new TIntArray;
+	protected int m_SalesTotal;
+
+	void AddPrice(int price)
+	{
+		m_Prices.InsertAt(price, LowerBound(m_Prices, price));
+	}
+
+	bool RemovePrice(int price)
+	{
+		int index = LowerBound(m_Prices, price);
+		if (index >= m_Prices.Count() || m_Prices[index] != price)
+			return false;
+
+		m_Prices.RemoveOrdered(index);
+
+		return true;
+	}
+
+	//! Keeps the RECENT_SALES_COUNT most recent sales, older sales are dropped
+	void AddSale(int time, int price)
+	{
+		int index = UpperBound(m_SaleTimes, time);
+		if (index == 0 && m_SaleTimes.Count() >= RECENT_SALES_COUNT)
+			return;
+
+		m_SaleTimes.InsertAt(time, index);
+		m_SalePrices.InsertAt(price, index);
+		m_SalesTotal += price;
+
+		if (m_SaleTimes.Count() > RECENT_SALES_COUNT)
+		{
+			m_SalesTotal -= m_SalePrices[0];
+			m_SaleTimes.RemoveOrdered(0);
+			m_SalePrices.RemoveOrdered(0);
+		}
+	}
+
+	int Count()
+	{
+		return m_Prices.Count();
+	}
+
+	bool IsEmpty()
+	{
+		return !m_Prices.Count() && !m_SalePrices.Count();
+	}
+
+	int GetMin()
+	{
+		if (!m_Prices.Count())
+			return 0;
+
+		return m_Prices[0];
+	}
+
+	int GetMax()
+	{
+		if (!m_Prices.Count())
+			return 0;
+
+		return m_Prices[m_Prices.Count() - 1];
+	}
+
+	int GetMedian()
+	{
+		int count = m_Prices.Count();
+		if (!count)
+			return 0;
+
+		if (count % 2)
+			return m_Prices[count / 2];
+
+		return Math.Round((m_Prices[count / 2 - 1] + m_Prices[count / 2]) * 0.5);
+	}
+
+	//! Each sale is one listing, so the volume weighted average is the average price of the recent sales
+	int GetRecentSalesVWAP()
+	{
+		if (!m_SalePrices.Count())
+			return 0;
+
+		float total = m_SalesTotal;
+
+		return Math.Round(total / m_SalePrices.Count());
+	}
+
+	void GetRange(ExpansionP2PMarketPriceRange range)
+	{
+		range.m_Count = Count();
+		range.m_Min = GetMin();
+		range.m_Max = GetMax();
+		range.m_Median = GetMedian();
+		range.m_RecentSalesCount = m_SalePrices.Count();
+		range.m_RecentSalesVWAP = GetRecentSalesVWAP();
+	}
+
+	//! Index of the first value >= `value`
+	protected static int LowerBound(TIntArray values, int value)
+	{
+		int low;
+		int high = values.Count();
+		while (low < high)
+		{
+			int mid = (low + high) / 2;
+			if (values[mid] < value)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+
+		return low;
+	}
+
+	//! Index of the first value > `value`
+	protected static int UpperBound(TIntArray values, int value)
+	{
+		int low;
+		int high = values.Count();
+		while (low < high)
+		{
+			int mid = (low + high) / 2;
+			if (values[mid] <= value)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+
+		return low;
+	}
+
+#ifdef EXPANSIONMODP2PMARKET_DEBUG
+	//! Listed prices match a naive recount (min, max and median follow from the sorted prices)
+	bool IsEqual(ExpansionP2PMarketPriceStats other)
+	{
+		if (!other)
+			return m_Prices.Count() == 0;
+
+		if (other.m_Prices.Count() != m_Prices.Count())
+			return false;
+
+		foreach (int i, int price: m_Prices)
+		{
+			if (other.m_Prices[i] != price)
+				return false;
+		}
+
+		return true;
+	}
+#endif
+}
+
+//! Server. Price aggregates per trader and type name, maintained on listing, removal and sale.
+//! Trader ID -1 holds the aggregates over all traders (used by global traders).
+class ExpansionP2PMarketPriceIndex
+{
+	protected ref map<int, ref map<string, ref ExpansionP2PMarketPriceStats>> m_Stats = new map<int, ref map<string, ref ExpansionP2PMarketPriceStats>>;
+
+	void OnListingAdded(ExpansionP2PMarketListing listing)
+	{
+		GetStats(listing.GetTraderID(), listing.GetClassName(), true).AddPrice(listing.GetPrice());
+		GetStats(-1, listing.GetClassName(), true).AddPrice(listing.GetPrice());
+	}
+
+	void OnListingRemoved(ExpansionP2PMarketListing listing)
+	{
+		RemovePrice(listing.GetTraderID(), listing.GetClassName(), listing.GetPrice());
+		RemovePrice(-1, listing.GetClassName(), listing.GetPrice());
+	}
+
+	void OnListingSold(ExpansionP2PMarketListing listing)
+	{
+		GetStats(listing.GetTraderID(), listing.GetClassName(), true).AddSale(listing.GetListingTime(), listing.GetPrice());
+		GetStats(-1, listing.GetClassName(), true).AddSale(listing.GetListingTime(), listing.GetPrice());
+	}
+
+	ExpansionP2PMarketPriceStats GetStats(int traderID, string className, bool create = false)
+	{
+		string type = className;
+		type.ToLower();
+
+		map<string, ref ExpansionP2PMarketPriceStats> traderStats = m_Stats[traderID];
+		if (!traderStats)
+		{
+			if (!create)
+				return null;
+
+			traderStats = new map<string, ref ExpansionP2PMarketPriceStats>;
+			m_Stats.Insert(traderID, traderStats);
+		}
+
+		ExpansionP2PMarketPriceStats stats = traderStats[type];
+		if (!stats && create)
+		{
+			stats = new ExpansionP2PMarketPriceStats;
+			traderStats.Insert(type, stats);
+		}
+
+		return stats;
+	}
+
+	ExpansionP2PMarketPriceRange GetRange(int traderID, string className)
+	{
+		ExpansionP2PMarketPriceRange range = new ExpansionP2PMarketPriceRange;
+		range.m_TraderID = traderID;
+		range.m_ClassName = className;
+
+		ExpansionP2PMarketPriceStats stats = GetStats(traderID, className);
+		if (stats)
+			stats.GetRange(range);
+
+		return range;
+	}
+
+#ifdef EXPANSIONMODP2PMARKET_DEBUG
+	//! Recounts listed prices from scratch and reports type names whose aggregates drifted, returns their number
+	int Audit(map<int, ref array<ref ExpansionP2PMarketListing>> listingsData)
+	{
+		ExpansionP2PMarketPriceIndex recount = new ExpansionP2PMarketPriceIndex;
+		foreach (int traderID, array<ref ExpansionP2PMarketListing> listings: listingsData)
+		{
+			foreach (ExpansionP2PMarketListing listing: listings)
+			{
+				if (listing)
+					recount.OnListingAdded(listing);
+			}
+		}
+
+		int mismatches;
+		foreach (int statsTraderID, map<string, ref ExpansionP2PMarketPriceStats> traderStats: m_Stats)
+		{
+			foreach (string type, ExpansionP2PMarketPriceStats stats: traderStats)
+			{
+				if (!stats.IsEqual(recount.GetStats(statsTraderID, type)))
+				{
+					EXPrint(ToString() + "::Audit - Mismatch for " + type + " (trader ID " + statsTraderID + ")");
+					mismatches++;
+				}
+			}
+		}
+
+		foreach (int recountTraderID, map<string, ref ExpansionP2PMarketPriceStats> recountStats: recount.m_Stats)
+		{
+			foreach (string recountType, ExpansionP2PMarketPriceStats recountTypeStats: recountStats)
+			{
+				if (!recountTypeStats.IsEqual(GetStats(recountTraderID, recountType)))
+				{
+					EXPrint(ToString() + "::Audit - Missing or mismatched " + recountType + " (trader ID " + recountTraderID + ")");
+					mismatches++;
+				}
+			}
+		}
+
+		return mismatches;
+	}
+#endif
+
+	protected void RemovePrice(int traderID, string className, int price)
+	{
+		ExpansionP2PMarketPriceStats stats = GetStats(traderID, className);
+		if (!stats || !stats.RemovePrice(price))
+		{
+			EXError.Warn(this, "::RemovePrice - No listed price " + price + " for " + className + " (trader ID " + traderID + ")");
+			return;
+		}
+
+		if (stats.IsEmpty())
+		{
+			string type = className;
+			type.ToLower();
+			m_Stats[traderID].Remove(type);
+		}
+	}
+}
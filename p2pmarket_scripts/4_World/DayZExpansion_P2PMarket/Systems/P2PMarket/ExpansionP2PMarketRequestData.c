@@ -25,6 +25,8 @@ class ExpansionP2PMarketRequestData
 	int m_MessagePriceString = 0;
 	bool m_OwnedListings = false;
 	string m_GlobalIDText = "";
+	ExpansionP2PMarketListingSortKey m_SortKey = ExpansionP2PMarketListingSortKey.NONE;
+	bool m_SortReverse = false;
 	
 	void Debug()
 	{
@@ -41,5 +43,6 @@ class ExpansionP2PMarketRequestData
 		ErrorEx("Message price string: " + m_MessagePriceString, ErrorExSeverity.INFO);
 		ErrorEx("Owned listings: " + m_OwnedListings, ErrorExSeverity.INFO);
 		ErrorEx("Global ID text: " + m_GlobalIDText, ErrorExSeverity.INFO);
+		ErrorEx("Sort key: " + typename.EnumToString(ExpansionP2PMarketListingSortKey, m_SortKey) + " | Reverse: " + m_SortReverse, ErrorExSeverity.INFO);
 	}
 };
\ No newline at end of file
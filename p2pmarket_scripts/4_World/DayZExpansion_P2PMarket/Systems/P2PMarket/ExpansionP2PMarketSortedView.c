@@ -0,0 +1,466 @@
+/**
+ * ExpansionP2PMarketSortedView.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2025 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+enum ExpansionP2PMarketListingSortKey
+{
+	NONE = 0,
+	NAME,
+	OWNER_NAME,
+	PRICE,
+	LISTING_TIME
+};
+
+class ExpansionP2PMarketSortedViewNode
+{
+	ExpansionP2PMarketListing m_Listing;
+	string m_GlobalIDText;
+	string m_SortKey;
+
+	int m_Priority;
+	int m_Size = 1;
+
+	ref ExpansionP2PMarketSortedViewNode m_Left;
+	ref ExpansionP2PMarketSortedViewNode m_Right;
+
+	void ExpansionP2PMarketSortedViewNode(ExpansionP2PMarketListing listing)
+	{
+		m_Listing = listing;
+		m_GlobalIDText = listing.GetEntityStorageBaseName();
+		m_Priority = Math.RandomInt(0, int.MAX);
+	}
+
+	void UpdateSize()
+	{
+		m_Size = 1;
+
+		if (m_Left)
+			m_Size += m_Left.m_Size;
+
+		if (m_Right)
+			m_Size += m_Right.m_Size;
+	}
+}
+
+//! Server. Listings of one trader (or all traders for global traders) and category, ordered by one sort key.
+//! Size-augmented treap, so insert, remove and lookup by rank are O(log n) and a page is O(page size * log n).
+//! Sort keys end in the global ID (see GetListingSortKey) so every listing has a unique rank.
+class ExpansionP2PMarketSortedView
+{
+	protected int m_TraderID;
+	protected int m_CategoryIndex;
+	protected int m_SubCategoryIndex;
+	protected ExpansionP2PMarketListingSortKey m_SortKey;
+
+	protected ref ExpansionP2PMarketSortedViewNode m_Root;
+	protected ref map<string, ExpansionP2PMarketSortedViewNode> m_Nodes;
+	protected map<string, string> m_DisplayNames;
+
+	void ExpansionP2PMarketSortedView(int traderID, int categoryIndex, int subCategoryIndex, ExpansionP2PMarketListingSortKey sortKey, map<string, string> displayNames)
+	{
+		m_TraderID = traderID;
+		m_CategoryIndex = categoryIndex;
+		m_SubCategoryIndex = subCategoryIndex;
+		m_SortKey = sortKey;
+		m_DisplayNames = displayNames;
+
+		m_Nodes = new map<string, ExpansionP2PMarketSortedViewNode>;
+	}
+
+	//! Listing belongs to this view (trader ID -1 = all traders, category/sub-category index -1 = all categories)
+	bool Accepts(ExpansionP2PMarketListing listing)
+	{
+		if (listing.GetListingState() != ExpansionP2PMarketListingState.LISTED)
+			return false;
+
+		if (m_TraderID > -1 && listing.GetTraderID() != m_TraderID)
+			return false;
+
+		if (m_CategoryIndex > -1 && listing.GetCategoryIndex() != m_CategoryIndex)
+			return false;
+
+		if (m_SubCategoryIndex > -1 && listing.GetSubCategoryIndex() != m_SubCategoryIndex)
+			return false;
+
+		return true;
+	}
+
+	bool Insert(ExpansionP2PMarketListing listing)
+	{
+		ExpansionP2PMarketSortedViewNode node = new ExpansionP2PMarketSortedViewNode(listing);
+		if (m_Nodes.Contains(node.m_GlobalIDText))
+			return false;
+
+		node.m_SortKey = GetListingSortKey(listing, m_SortKey, m_DisplayNames);
+
+		m_Root = InsertNode(m_Root, node);
+		m_Nodes.Insert(node.m_GlobalIDText, node);
+
+		return true;
+	}
+
+	bool Remove(ExpansionP2PMarketListing listing)
+	{
+		string globalIDText = listing.GetEntityStorageBaseName();
+
+		ExpansionP2PMarketSortedViewNode node;
+		if (!m_Nodes.Find(globalIDText, node))
+			return false;
+
+		m_Root = RemoveNode(m_Root, node);
+		m_Nodes.Remove(globalIDText);
+
+		return true;
+	}
+
+	int Count()
+	{
+		if (!m_Root)
+			return 0;
+
+		return m_Root.m_Size;
+	}
+
+	//! Returns listing at the given rank, NULL if out of range
+	ExpansionP2PMarketListing At(int rank, bool reverse = false)
+	{
+		if (reverse)
+			rank = Count() - 1 - rank;
+
+		ExpansionP2PMarketSortedViewNode node = m_Root;
+		while (node)
+		{
+			int leftSize = GetSize(node.m_Left);
+			if (rank < leftSize)
+			{
+				node = node.m_Left;
+			}
+			else if (rank == leftSize)
+			{
+				return node.m_Listing;
+			}
+			else
+			{
+				rank -= leftSize + 1;
+				node = node.m_Right;
+			}
+		}
+
+		return null;
+	}
+
+	//! Returns rank of the given listing, -1 if it is not part of this view
+	int GetRank(ExpansionP2PMarketListing listing, bool reverse = false)
+	{
+		ExpansionP2PMarketSortedViewNode target;
+		if (!m_Nodes.Find(listing.GetEntityStorageBaseName(), target))
+			return -1;
+
+		int rank;
+		ExpansionP2PMarketSortedViewNode node = m_Root;
+		while (node)
+		{
+			if (node == target)
+			{
+				rank += GetSize(node.m_Left);
+				if (reverse)
+					return Count() - 1 - rank;
+
+				return rank;
+			}
+
+			if (Compare(target, node) < 0)
+			{
+				node = node.m_Left;
+			}
+			else
+			{
+				rank += GetSize(node.m_Left) + 1;
+				node = node.m_Right;
+			}
+		}
+
+		return -1;
+	}
+
+	//! Appends up to `count` listings starting at rank `start` to `listings`, returns number of appended listings
+	int GetPage(int start, int count, bool reverse, array<ref ExpansionP2PMarketListing> listings)
+	{
+		int end = Math.Min(start + count, Count());
+		for (int rank = start; rank < end; ++rank)
+		{
+			listings.Insert(At(rank, reverse));
+		}
+
+		return Math.Max(end - start, 0);
+	}
+
+	ExpansionP2PMarketListingSortKey GetSortKey()
+	{
+		return m_SortKey;
+	}
+
+	//! Server and client. Sort key of a listing, ordered by plain string comparison.
+	//! Numbers are zero-padded and the global ID is appended as tie-breaker, so the client orders a page exactly like the view it came from.
+	static string GetListingSortKey(ExpansionP2PMarketListing listing, ExpansionP2PMarketListingSortKey sortKey, map<string, string> displayNames)
+	{
+		string key;
+
+		switch (sortKey)
+		{
+			case ExpansionP2PMarketListingSortKey.NAME:
+				string type = listing.GetClassName();
+				type.ToLower();
+				key = ExpansionStatic.GetItemDisplayNameWithType(type, displayNames);
+				key.ToLower();
+				break;
+			case ExpansionP2PMarketListingSortKey.OWNER_NAME:
+				key = listing.GetOwnerName();
+				key.ToLower();
+				break;
+			case ExpansionP2PMarketListingSortKey.PRICE:
+				key = listing.GetPrice().ToStringLen(10);
+				break;
+			case ExpansionP2PMarketListingSortKey.LISTING_TIME:
+				key = listing.GetListingTime().ToStringLen(10);
+				break;
+		}
+
+		return key + "\t" + listing.GetEntityStorageBaseName();
+	}
+
+	protected int Compare(ExpansionP2PMarketSortedViewNode a, ExpansionP2PMarketSortedViewNode b)
+	{
+		if (a.m_SortKey < b.m_SortKey)
+			return -1;
+		if (a.m_SortKey > b.m_SortKey)
+			return 1;
+
+		return 0;
+	}
+
+	protected int GetSize(ExpansionP2PMarketSortedViewNode node)
+	{
+		if (!node)
+			return 0;
+
+		return node.m_Size;
+	}
+
+	protected ExpansionP2PMarketSortedViewNode InsertNode(ExpansionP2PMarketSortedViewNode root, ExpansionP2PMarketSortedViewNode node)
+	{
+		if (!root)
+			return node;
+
+		if (Compare(node, root) < 0)
+		{
+			root.m_Left = InsertNode(root.m_Left, node);
+			if (root.m_Left.m_Priority > root.m_Priority)
+				return RotateRight(root);
+		}
+		else
+		{
+			root.m_Right = InsertNode(root.m_Right, node);
+			if (root.m_Right.m_Priority > root.m_Priority)
+				return RotateLeft(root);
+		}
+
+		root.UpdateSize();
+
+		return root;
+	}
+
+	protected ExpansionP2PMarketSortedViewNode RemoveNode(ExpansionP2PMarketSortedViewNode root, ExpansionP2PMarketSortedViewNode node)
+	{
+		if (!root)
+			return null;
+
+		if (root == node)
+		{
+			ExpansionP2PMarketSortedViewNode merged = Merge(root.m_Left, root.m_Right);
+			root.m_Left = null;
+			root.m_Right = null;
+			return merged;
+		}
+
+		if (Compare(node, root) < 0)
+			root.m_Left = RemoveNode(root.m_Left, node);
+		else
+			root.m_Right = RemoveNode(root.m_Right, node);
+
+		root.UpdateSize();
+
+		return root;
+	}
+
+	protected ExpansionP2PMarketSortedViewNode Merge(ExpansionP2PMarketSortedViewNode left, ExpansionP2PMarketSortedViewNode right)
+	{
+		if (!left)
+			return right;
+
+		if (!right)
+			return left;
+
+		if (left.m_Priority > right.m_Priority)
+		{
+			left.m_Right = Merge(left.m_Right, right);
+			left.UpdateSize();
+			return left;
+		}
+
+		right.m_Left = Merge(left, right.m_Left);
+		right.UpdateSize();
+
+		return right;
+	}
+
+	protected ExpansionP2PMarketSortedViewNode RotateRight(ExpansionP2PMarketSortedViewNode root)
+	{
+		ExpansionP2PMarketSortedViewNode left = root.m_Left;
+		root.m_Left = left.m_Right;
+		left.m_Right = root;
+
+		root.UpdateSize();
+		left.UpdateSize();
+
+		return left;
+	}
+
+	protected ExpansionP2PMarketSortedViewNode RotateLeft(ExpansionP2PMarketSortedViewNode root)
+	{
+		ExpansionP2PMarketSortedViewNode right = root.m_Right;
+		root.m_Right = right.m_Left;
+		right.m_Left = root;
+
+		root.UpdateSize();
+		right.UpdateSize();
+
+		return right;
+	}
+
+#ifdef EXPANSIONMODP2PMARKET_DEBUG
+	//! Checks that ranks are strictly ordered, subtree sizes add up and every indexed listing can be found at its rank
+	int CheckConsistency()
+	{
+		int errors;
+		int count = Count();
+
+		if (count != m_Nodes.Count())
+		{
+			EXPrint(ToString() + "::CheckConsistency - Tree size " + count + " != indexed listings " + m_Nodes.Count());
+			errors++;
+		}
+
+		ExpansionP2PMarketSortedViewNode previous;
+		for (int rank = 0; rank < count; ++rank)
+		{
+			ExpansionP2PMarketSortedViewNode node = m_Nodes[At(rank).GetEntityStorageBaseName()];
+			if (previous && Compare(previous, node) >= 0)
+			{
+				EXPrint(ToString() + "::CheckConsistency - Rank " + rank + " (" + node.m_GlobalIDText + ") is not ordered after " + previous.m_GlobalIDText);
+				errors++;
+			}
+
+			if (GetRank(node.m_Listing) != rank)
+			{
+				EXPrint(ToString() + "::CheckConsistency - Rank of " + node.m_GlobalIDText + " is " + GetRank(node.m_Listing) + ", expected " + rank);
+				errors++;
+			}
+
+			previous = node;
+		}
+
+		return errors;
+	}
+#endif
+}
+
+//! Server. Sorted views are created on first request for a trader/category/sort key combination
+//! and kept up to date incrementally afterwards.
+class ExpansionP2PMarketSortedViews
+{
+	protected ref map<string, ref ExpansionP2PMarketSortedView> m_Views = new map<string, ref ExpansionP2PMarketSortedView>;
+	protected ref map<string, string> m_DisplayNames = new map<string, string>;
+
+	static string GetViewKey(int traderID, int categoryIndex, int subCategoryIndex, ExpansionP2PMarketListingSortKey sortKey)
+	{
+		return string.Format("%1:%2:%3:%4", traderID, categoryIndex, subCategoryIndex, sortKey);
+	}
+
+	ExpansionP2PMarketSortedView Find(int traderID, int categoryIndex, int subCategoryIndex, ExpansionP2PMarketListingSortKey sortKey)
+	{
+		return m_Views[GetViewKey(traderID, categoryIndex, subCategoryIndex, sortKey)];
+	}
+
+	//! Returns view for the given trader (-1 = all traders), category and sort key, building it from `listingsData` if it doesn't exist yet
+	ExpansionP2PMarketSortedView Get(int traderID, int categoryIndex, int subCategoryIndex, ExpansionP2PMarketListingSortKey sortKey, map<int, ref array<ref ExpansionP2PMarketListing>> listingsData)
+	{
+		string key = GetViewKey(traderID, categoryIndex, subCategoryIndex, sortKey);
+
+		ExpansionP2PMarketSortedView view;
+		if (m_Views.Find(key, view))
+			return view;
+
+		int start = TickCount(0);
+
+		view = new ExpansionP2PMarketSortedView(traderID, categoryIndex, subCategoryIndex, sortKey, m_DisplayNames);
+
+		foreach (int listingsTraderID, array<ref ExpansionP2PMarketListing> listings: listingsData)
+		{
+			if (traderID > -1 && listingsTraderID != traderID)
+				continue;
+
+			foreach (ExpansionP2PMarketListing listing: listings)
+			{
+				if (listing && view.Accepts(listing))
+					view.Insert(listing);
+			}
+		}
+
+		m_Views.Insert(key, view);
+
+		EXPrint(ToString() + "::Get - Built view " + key + " with " + view.Count() + " listings in " + (TickCount(start) / 10000.0) + " ms");
+
+	#ifdef EXPANSIONMODP2PMARKET_DEBUG
+		view.CheckConsistency();
+	#endif
+
+		return view;
+	}
+
+	void Insert(ExpansionP2PMarketListing listing)
+	{
+		foreach (ExpansionP2PMarketSortedView view: m_Views)
+		{
+			if (view.Accepts(listing))
+				view.Insert(listing);
+		}
+	}
+
+	void Remove(ExpansionP2PMarketListing listing)
+	{
+		foreach (ExpansionP2PMarketSortedView view: m_Views)
+		{
+			view.Remove(listing);
+		}
+	}
+
+	//! Views are rebuilt on next request, e.g. after category indices of listings changed
+	void Clear()
+	{
+		m_Views.Clear();
+	}
+
+	int Count()
+	{
+		return m_Views.Count();
+	}
+}
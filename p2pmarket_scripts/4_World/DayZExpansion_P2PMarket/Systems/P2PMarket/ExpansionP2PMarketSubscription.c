@@ -0,0 +1,162 @@
+/**
+ * ExpansionP2PMarketSubscription.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2025 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+//! Server. Query and current page of a player viewing a P2P trader.
+class ExpansionP2PMarketSubscription
+{
+	string m_PlayerUID;
+	int m_TraderID = -1;
+	bool m_IsGlobal;
+	bool m_SoldListings;
+	int m_PageIndex;
+	int m_CategoryIndex = -1;
+	int m_SubCategoryIndex = -1;
+	ref array<string> m_SearchTypeNames = new array<string>;
+	bool m_OwnedListings;
+	ExpansionP2PMarketListingSortKey m_SortKey;
+	bool m_SortReverse;
+
+	//! Global ID texts of the listings on the page the player currently sees
+	ref TStringArray m_PageGlobalIDs = new TStringArray;
+
+	void ExpansionP2PMarketSubscription(string playerUID, int traderID, bool isGlobal)
+	{
+		m_PlayerUID = playerUID;
+		m_TraderID = traderID;
+		m_IsGlobal = isGlobal;
+	}
+
+	void SetQuery(ExpansionP2PMarketRequestData data, bool soldListings)
+	{
+		m_SoldListings = soldListings;
+		m_PageIndex = data.m_PageIndex;
+		m_CategoryIndex = data.m_CategoryIndex;
+		m_SubCategoryIndex = data.m_SubCategoryIndex;
+		m_OwnedListings = data.m_OwnedListings;
+		m_SortKey = data.m_SortKey;
+		m_SortReverse = data.m_SortReverse;
+
+		m_SearchTypeNames.Clear();
+		if (data.m_SearchTypeNames)
+			m_SearchTypeNames.Copy(data.m_SearchTypeNames);
+	}
+
+	void SetPage(array<ref ExpansionP2PMarketListing> listings)
+	{
+		m_PageGlobalIDs.Clear();
+
+		foreach (ExpansionP2PMarketListing listing: listings)
+		{
+			m_PageGlobalIDs.Insert(listing.GetEntityStorageBaseName());
+		}
+	}
+
+	bool IsPageFull(int listingsPerPage)
+	{
+		return m_PageGlobalIDs.Count() >= listingsPerPage;
+	}
+
+	//! Page is served from a sorted view (see ExpansionP2PMarketModule::SendBasicListingData)
+	bool IsSorted()
+	{
+		return m_SortKey != ExpansionP2PMarketListingSortKey.NONE && !m_OwnedListings && !m_SearchTypeNames.Count();
+	}
+
+	bool IsOnPage(string globalIDText)
+	{
+		return m_PageGlobalIDs.Find(globalIDText) > -1;
+	}
+}
+
+//! Server. Players currently viewing P2P traders, keyed by trader ID. Viewers of global traders see listings of all traders
+//! and are kept in a separate channel.
+class ExpansionP2PMarketSubscriptionRegistry
+{
+	protected ref map<int, ref map<string, ref ExpansionP2PMarketSubscription>> m_TraderSubscriptions = new map<int, ref map<string, ref ExpansionP2PMarketSubscription>>;
+	protected ref map<string, ref ExpansionP2PMarketSubscription> m_GlobalSubscriptions = new map<string, ref ExpansionP2PMarketSubscription>;
+	protected ref map<string, ExpansionP2PMarketSubscription> m_PlayerSubscriptions = new map<string, ExpansionP2PMarketSubscription>;
+
+	ExpansionP2PMarketSubscription Subscribe(string playerUID, int traderID, bool isGlobal)
+	{
+		ExpansionP2PMarketSubscription subscription = m_PlayerSubscriptions[playerUID];
+		if (subscription && subscription.m_TraderID == traderID)
+			return subscription;
+
+		Unsubscribe(playerUID);
+
+		subscription = new ExpansionP2PMarketSubscription(playerUID, traderID, isGlobal);
+
+		if (isGlobal)
+		{
+			m_GlobalSubscriptions.Insert(playerUID, subscription);
+		}
+		else
+		{
+			map<string, ref ExpansionP2PMarketSubscription> subscriptions = m_TraderSubscriptions[traderID];
+			if (!subscriptions)
+			{
+				subscriptions = new map<string, ref ExpansionP2PMarketSubscription>;
+				m_TraderSubscriptions.Insert(traderID, subscriptions);
+			}
+
+			subscriptions.Insert(playerUID, subscription);
+		}
+
+		m_PlayerSubscriptions.Insert(playerUID, subscription);
+
+		return subscription;
+	}
+
+	void Unsubscribe(string playerUID)
+	{
+		ExpansionP2PMarketSubscription subscription;
+		if (!m_PlayerSubscriptions.Find(playerUID, subscription))
+			return;
+
+		m_PlayerSubscriptions.Remove(playerUID);
+
+		if (subscription.m_IsGlobal)
+		{
+			m_GlobalSubscriptions.Remove(playerUID);
+		}
+		else
+		{
+			map<string, ref ExpansionP2PMarketSubscription> subscriptions = m_TraderSubscriptions[subscription.m_TraderID];
+			if (subscriptions)
+			{
+				subscriptions.Remove(playerUID);
+				if (!subscriptions.Count())
+					m_TraderSubscriptions.Remove(subscription.m_TraderID);
+			}
+		}
+	}
+
+	ExpansionP2PMarketSubscription Get(string playerUID)
+	{
+		return m_PlayerSubscriptions[playerUID];
+	}
+
+	map<string, ref ExpansionP2PMarketSubscription> GetTraderSubscriptions(int traderID)
+	{
+		return m_TraderSubscriptions[traderID];
+	}
+
+	map<string, ref ExpansionP2PMarketSubscription> GetGlobalSubscriptions()
+	{
+		return m_GlobalSubscriptions;
+	}
+
+	int Count()
+	{
+		return m_PlayerSubscriptions.Count();
+	}
+}
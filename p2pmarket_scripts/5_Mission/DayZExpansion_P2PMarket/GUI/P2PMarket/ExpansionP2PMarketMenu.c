@@ -153,6 +153,9 @@ class ExpansionP2PMarketMenu: ExpansionScriptViewMenu
 	protected int m_OwnedListingsCount;
 	protected int m_ValidListingsCount;
 	protected bool m_UseValidListingsCount;
+	protected ExpansionP2PMarketListingSortKey m_SortKey;
+	protected bool m_SortReverse;
+	protected ref map<string, string> m_DisplayNames = new map<string, string>;
 	protected ExpansionP2PMarketMenuItemBase m_InspectingElement;
 
 	void ExpansionP2PMarketMenu()
@@ -169,6 +172,9 @@ class ExpansionP2PMarketMenu: ExpansionScriptViewMenu
 		m_P2PMarketModule.GetListingDetailsSI().Insert(OnListingDetailsRecived);
 		m_P2PMarketModule.GetCallbackSI().Insert(OnModuleCallback);
 		m_P2PMarketModule.GetUpdateSI().Insert(OnListingsUpdate);
+		m_P2PMarketModule.GetListingAddedSI().Insert(OnListingAdded);
+		m_P2PMarketModule.GetPriceRangeSI().Insert(OnPriceRangeReceived);
+		m_P2PMarketModule.SetListingsSort(ExpansionP2PMarketListingSortKey.NONE);
 		
 		m_P2PMarketSettings = GetExpansionSettings().GetP2PMarket();
 
@@ -209,6 +215,8 @@ class ExpansionP2PMarketMenu: ExpansionScriptViewMenu
 			m_P2PMarketModule.GetListingDetailsSI().Remove(OnListingDetailsRecived);
 			m_P2PMarketModule.GetCallbackSI().Remove(OnModuleCallback);
 			m_P2PMarketModule.GetUpdateSI().Remove(OnListingsUpdate);
+			m_P2PMarketModule.GetListingAddedSI().Remove(OnListingAdded);
+			m_P2PMarketModule.GetPriceRangeSI().Remove(OnPriceRangeReceived);
 		}
 
 		if (m_ItemDetailsView)
@@ -361,7 +369,7 @@ class ExpansionP2PMarketMenu: ExpansionScriptViewMenu
 				}
 			}
 
-			SortListingsByName();
+			SortListings();
 		}
 
 		if (m_SoldListingsCount > 0)
@@ -636,6 +644,11 @@ class ExpansionP2PMarketMenu: ExpansionScriptViewMenu
 				ExpansionNotification(new StringLocaliser("STR_EXPANSION_MARKET_P2P_NOTIF_LISTING_ERROR_TITLE"), new StringLocaliser("STR_EXPANSION_MARKET_P2P_NOTIF_PERSISTENCY_MISSING", displayName), ExpansionIcons.GetPath("Exclamationmark"), COLOR_EXPANSION_NOTIFICATION_ERROR, 7, ExpansionNotificationType.TOAST).Create();
 				break;
 			}
+			case ExpansionP2PMarketModuleCallback.ErrorWarmingUp:
+			{
+				ExpansionNotification(new StringLocaliser("STR_EXPANSION_MARKET_P2P_NOTIF_WARMING_UP_TITLE"), new StringLocaliser("STR_EXPANSION_MARKET_P2P_NOTIF_WARMING_UP_DESC"), ExpansionIcons.GetPath("Exclamationmark"), COLOR_EXPANSION_NOTIFICATION_ERROR, 7, ExpansionNotificationType.TOAST).Create();
+				break;
+			}
 			case ExpansionP2PMarketModuleCallback.MsgItemGotSold:
 			{
 				tabs_button_sales.Show(true);
@@ -740,6 +753,23 @@ class ExpansionP2PMarketMenu: ExpansionScriptViewMenu
 		}
 	}
 
+	//! Listing that matches the current query was added while the current page still has room for it
+	void OnListingAdded(ExpansionP2PMarketListing listing)
+	{
+		#ifdef EXTRACE
+		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
+		#endif
+
+		if (m_ViewState != ExpansionP2PMarketMenuViewState.ViewBrowse || m_ItemListings.Count() >= LISTINGS_PER_PAGE_COUNT)
+			return;
+
+		m_ItemListings.Insert(new ExpansionP2PMarketMenuListing(listing, this));
+		SortListings();
+
+		m_ListingsCount++;
+		UpdatePageButtons();
+	}
+
 	//! This method allows mods to override GetPreviewClassName while still keeping the original code in one place
 	string GetPreviewClassName(string className, bool ignoreBaseBuildingKits = false)
 	{
@@ -1030,29 +1060,10 @@ class ExpansionP2PMarketMenu: ExpansionScriptViewMenu
 			}
 		}
 
-		int lowest = GetLowestListingPrice(item.GetPlayerItem().GetClassName());
-		if (lowest > 0)
-		{
-			GetDetailsView().GetDetailsViewController().LowestPrice = GetDisplayPrice(lowest, false, true, true);
-		}
-		else
-		{
-			GetDetailsView().GetDetailsViewController().LowestPrice = "#STR_EXPANSION_MARKET_P2P_NAN";
-		}
-
-		GetDetailsView().GetDetailsViewController().NotifyPropertyChanged("LowestPrice");
-
-		int highest = GetHighestListingPrice(item.GetPlayerItem().GetClassName());
-		if (highest > 0)
-		{
-			GetDetailsView().GetDetailsViewController().HighestPrice = GetDisplayPrice(highest, false, true, true);
-		}
-		else
-		{
-			GetDetailsView().GetDetailsViewController().HighestPrice = "#STR_EXPANSION_MARKET_P2P_NAN";
-		}
-
-		GetDetailsView().GetDetailsViewController().NotifyPropertyChanged("HighestPrice");
+		//! Lowest and highest price of all listings of this type at the trader, filled in by OnPriceRangeReceived
+		ExpansionP2PMarketPriceRange emptyRange = new ExpansionP2PMarketPriceRange();
+		SetPriceRange(emptyRange);
+		m_P2PMarketModule.RequestPriceRange(m_TraderID, item.GetPlayerItem().GetClassName());
 
 		if (GetExpansionSettings().GetMarket().MarketSystemEnabled)
 		{
@@ -1558,100 +1569,56 @@ class ExpansionP2PMarketMenu: ExpansionScriptViewMenu
 		}
 	}
 
-	void SortListingsByName(bool reverse = false)
+	//! Orders the current page by the same sort keys the server uses for its sorted views
+	void SortListings()
 	{
-		TStringArray displayName = new TStringArray;
-		foreach (ExpansionP2PMarketMenuListing entry: m_ItemListings)
-		{
-			if (!entry || !entry.GetListing())
-				continue;
-
-			displayName.Insert(entry.GetPreviewObject().GetDisplayName());
-		}
+		ExpansionP2PMarketListingSortKey sortKey = m_SortKey;
+		if (sortKey == ExpansionP2PMarketListingSortKey.NONE)
+			sortKey = ExpansionP2PMarketListingSortKey.NAME;
 
-		displayName.Sort(reverse);
-
-		foreach (ExpansionP2PMarketMenuListing currentEntry: m_ItemListings)
-		{
-			if (!currentEntry || !currentEntry.GetListing())
-				continue;
-
-			string name = currentEntry.GetPreviewObject().GetDisplayName();
-			int index = displayName.Find(name) + 1;
-			currentEntry.SetSort(index, false);
-		}
-	}
-
-	void SortListingsByOwnerName(bool reverse = false)
-	{
-		TStringArray ownerName = new TStringArray;
+		array<ExpansionP2PMarketMenuListing> entries = new array<ExpansionP2PMarketMenuListing>;
+		TStringArray keys = new TStringArray;
 		foreach (ExpansionP2PMarketMenuListing entry: m_ItemListings)
 		{
 			if (!entry || !entry.GetListing())
 				continue;
 
-			ownerName.Insert(entry.GetListing().GetOwnerName());
+			entries.Insert(entry);
+			keys.Insert(ExpansionP2PMarketSortedView.GetListingSortKey(entry.GetListing(), sortKey, m_DisplayNames));
 		}
 
-		ownerName.Sort(reverse);
+		TStringArray sortedKeys = new TStringArray;
+		sortedKeys.Copy(keys);
+		sortedKeys.Sort(m_SortReverse);
 
-		foreach (ExpansionP2PMarketMenuListing currentEntry: m_ItemListings)
+		map<string, int> positions = new map<string, int>;
+		foreach (int i, string sortedKey: sortedKeys)
 		{
-			if (!currentEntry || !currentEntry.GetListing())
-				continue;
-
-			string name = entry.GetListing().GetOwnerName();
-			int index = ownerName.Find(name) + 1;
-			currentEntry.SetSort(index, false);
+			positions.Insert(sortedKey, i + 1);
 		}
-	}
 
-	void SortListingsByPrice(bool reverse = false)
-	{
-		TIntArray prices = new TIntArray;
-		foreach (ExpansionP2PMarketMenuListing entry: m_ItemListings)
-		{
-			if (!entry || !entry.GetListing())
-				continue;
-
-			prices.Insert(entry.GetListing().GetPrice());
-		}
-
-		prices.Sort(reverse);
-
-		foreach (ExpansionP2PMarketMenuListing currentEntry: m_ItemListings)
+		foreach (int j, ExpansionP2PMarketMenuListing currentEntry: entries)
 		{
-			if (!currentEntry || !currentEntry.GetListing())
-				continue;
-
-			int price = currentEntry.GetListing().GetPrice();
-			int index = prices.Find(price) + 1;
-			currentEntry.SetSort(index, false);
+			currentEntry.SetSort(positions[keys[j]], false);
 		}
 	}
 
-	void SortListingsByTime(bool reverse = false)
+	//! Sorts the current page and, if the server can serve the query from a sorted view, requests the first page in global order
+	protected void SetListingsSort(ExpansionP2PMarketListingSortKey sortKey, bool reverse)
 	{
-		TIntArray times = new TIntArray;
-		foreach (ExpansionP2PMarketMenuListing entry: m_ItemListings)
-		{
-			if (!entry || !entry.GetListing())
-				continue;
+		m_SortKey = sortKey;
+		m_SortReverse = reverse;
+		m_P2PMarketModule.SetListingsSort(sortKey, reverse);
 
-			times.Insert(entry.GetRemainingTime());
-		}
+		SortListings();
 
-		times.Sort(reverse);
+		if (m_ViewState != ExpansionP2PMarketMenuViewState.ViewBrowse || m_OwnedListings || market_filter_box.GetText() != "")
+			return;
 
-		foreach (ExpansionP2PMarketMenuListing currentEntry: m_ItemListings)
-		{
-			if (!currentEntry || !currentEntry.GetListing())
-				continue;
+		m_PageIndex = 0;
+		m_PageStartNum = 1;
 
-			int time = currentEntry.GetRemainingTime();
-			int index = times.Find(time) + 1;
-			currentEntry.SetSort(index, false);
-		}
+		m_P2PMarketModule.RequestBasicListingData(m_TraderID, m_PageIndex, false, m_CategoryIndex, m_SubCategoryIndex, null, m_OwnedListings);
 	}
 
 	void OnListButtonClick()
@@ -1840,42 +1807,42 @@ class ExpansionP2PMarketMenu: ExpansionScriptViewMenu
 
 	void Listings_Filter_ClassNameAZ()
 	{
-		SortListingsByName();
+		SetListingsSort(ExpansionP2PMarketListingSortKey.NAME, false);
 	}
 
 	void Listings_Filter_ClassNameZA()
 	{
-		SortListingsByName(true);
+		SetListingsSort(ExpansionP2PMarketListingSortKey.NAME, true);
 	}
 
 	void Listings_Filter_OwnerNameAZ()
 	{
-		SortListingsByName();
+		SetListingsSort(ExpansionP2PMarketListingSortKey.OWNER_NAME, false);
 	}
 
 	void Listings_Filter_OwnerNameZA()
 	{
-		SortListingsByOwnerName(true);
+		SetListingsSort(ExpansionP2PMarketListingSortKey.OWNER_NAME, true);
 	}
 
 	void Listings_Filter_PriceLH()
 	{
-		SortListingsByPrice();
+		SetListingsSort(ExpansionP2PMarketListingSortKey.PRICE, false);
 	}
 
 	void Listings_Filter_PriceHL()
 	{
-		SortListingsByPrice(true);
+		SetListingsSort(ExpansionP2PMarketListingSortKey.PRICE, true);
 	}
 
 	void Listings_Filter_TimeSL()
 	{
-		SortListingsByTime();
+		SetListingsSort(ExpansionP2PMarketListingSortKey.LISTING_TIME, false);
 	}
 
 	void Listings_Filter_TimeLS()
 	{
-		SortListingsByTime(true);
+		SetListingsSort(ExpansionP2PMarketListingSortKey.LISTING_TIME, true);
 	}
 
 	//! CATEGORIES
@@ -2722,40 +2689,35 @@ class ExpansionP2PMarketMenu: ExpansionScriptViewMenu
 		return m_SelectedContainerItems;
 	}
 
-	protected int GetLowestListingPrice(string typeName)
+	void OnPriceRangeReceived(ExpansionP2PMarketPriceRange range)
 	{
-		int lowest;
-		foreach (ExpansionP2PMarketMenuListing entry: m_ItemListings)
-		{
-			if (!entry || !entry.GetListing())
-				continue;
+		#ifdef EXTRACE
+		auto trace = EXTrace.Start(EXTrace.P2PMARKET, this);
+		#endif
 
-			if (entry.GetListing().GetClassName() != typeName)
-				continue;
+		if (range.m_TraderID != m_TraderID || !m_SelectedPlayerItem || !m_SelectedPlayerItem.GetPlayerItem())
+			return;
 
-			if (lowest == 0 || lowest != 0 && entry.GetListing().GetPrice() < lowest)
-				lowest = entry.GetListing().GetPrice();
-		}
+		if (m_SelectedPlayerItem.GetPlayerItem().GetClassName() != range.m_ClassName)
+			return;
 
-		return lowest;
+		SetPriceRange(range);
 	}
 
-	protected int GetHighestListingPrice(string typeName)
+	protected void SetPriceRange(ExpansionP2PMarketPriceRange range)
 	{
-		int highest;
-		foreach (ExpansionP2PMarketMenuListing entry: m_ItemListings)
+		if (range.m_Count > 0)
 		{
-			if (!entry || !entry.GetListing())
-				continue;
-
-			if (entry.GetListing().GetClassName() != typeName)
-				continue;
-
-			if (highest == 0 || highest != 0 && entry.GetListing().GetPrice() > highest)
-				highest = entry.GetListing().GetPrice();
+			GetDetailsView().GetDetailsViewController().LowestPrice = GetDisplayPrice(range.m_Min, false, true, true);
+			GetDetailsView().GetDetailsViewController().HighestPrice = GetDisplayPrice(range.m_Max, false, true, true);
+		}
+		else
+		{
+			GetDetailsView().GetDetailsViewController().LowestPrice = "#STR_EXPANSION_MARKET_P2P_NAN";
+			GetDetailsView().GetDetailsViewController().HighestPrice = "#STR_EXPANSION_MARKET_P2P_NAN";
 		}
 
-		return highest;
+		GetDetailsView().GetDetailsViewController().NotifyPropertiesChanged({"LowestPrice", "HighestPrice"});
 	}
 
 	int GetCategoryListingsCount(ExpansionP2PMarketMenuCategoryBase category)
@@ -2766,9 +2728,7 @@ class ExpansionP2PMarketMenu: ExpansionScriptViewMenu
 			if (!entry || !entry.GetListing())
 				continue;
 
-			TStringArray included = category.GetIncluded();
-			TStringArray excluded = category.GetExcluded();
-			if (ExpansionStatic.IsAnyOf(entry.GetPreviewObject(), included) && !ExpansionStatic.IsAnyOf(entry.GetPreviewObject(), excluded))
+			if (m_P2PMarketSettings.GetCategoryMatch(entry.GetListing().GetClassName()).Matches(category))
 				count++;
 		}
 